@@ -13,11 +13,22 @@
  */
 #include <libtermbench/termbench.h>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
 #include <cstdlib>
 #include <format>
+#include <initializer_list>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <ostream>
+#include <span>
+#include <thread>
+#include <unordered_set>
 #include <utility>
 
 using namespace std::chrono;
@@ -37,9 +48,11 @@ using u16 = unsigned short;
 Benchmark::Benchmark(std::function<void(char const*, size_t n)> _writer,
                      size_t _testSizeMB,
                      TerminalSize terminalSize,
-                     std::function<void(Test const&)> _beforeTest):
+                     std::function<void(Test const&)> _beforeTest,
+                     std::function<bool()> _roundTrip):
     writer_ { std::move(_writer) },
     beforeTest_ { std::move(_beforeTest) },
+    roundTrip_ { std::move(_roundTrip) },
     testSizeMB_ { _testSizeMB },
     terminalSize_ { terminalSize }
 {
@@ -61,38 +74,174 @@ void Benchmark::updateWindowTitle(std::string_view _title)
     std::cout.flush();
 }
 
-void Benchmark::writeOutput(Buffer const& testBuffer)
+steady_clock::duration Benchmark::writeOutput(Buffer const& testBuffer, Test const& test, Result& result)
 {
     auto const output = testBuffer.output();
-    auto remainingBytes = totalSizeBytes();
-    while (remainingBytes > 0)
+    auto const& roundTripRequests = test.roundTripRequests;
+    auto const phaseSize = test.phaseSize != 0 ? test.phaseSize : result.bytesWritten;
+    auto phaseBegin = steady_clock::now();
+
+    // A round trip without a reply is not recorded, and no further round trips are attempted.
+    // The same goes for a resize that the terminal size probe does not confirm in time.
+    // The time spent waiting for either is not part of the test's time.
+    auto unansweredTime = steady_clock::duration {};
+    auto const roundTrip = [&](RoundTripRequest const& request) {
+        auto const beginTime = steady_clock::now();
+        auto const exclude = [&]() {
+            auto const time = steady_clock::now() - beginTime;
+            unansweredTime += time;
+            phaseBegin += time;
+        };
+
+        if (!roundTrip_())
+        {
+            roundTrip_ = {};
+            exclude();
+            return;
+        }
+
+        if (request.terminalSize)
+        {
+            // A resize that cannot be confirmed is not recorded.
+            if (!terminalSizeProbe_)
+                return;
+            // Terminals may apply resizes asynchronously, after answering the DA1 request.
+            while (terminalSizeProbe_() != *request.terminalSize && steady_clock::now() - beginTime < 1s)
+                std::this_thread::sleep_for(100us);
+            if (terminalSizeProbe_() != *request.terminalSize)
+            {
+                terminalSizeProbe_ = {};
+                exclude();
+                return;
+            }
+        }
+
+        if (request.recorded)
+            result.roundTrips.emplace_back(duration_cast<microseconds>(steady_clock::now() - beginTime));
+    };
+
+    // The buffer is written repeatedly until the total size is reached,
+    // stopping at requested round trips and at the end of each phase.
+    size_t written = 0;
+    size_t offset = 0;
+    size_t nextRoundTrip = 0;
+    size_t phaseEnd = phaseSize;
+    while (written < result.bytesWritten)
     {
-        auto const n = std::min(output.size(), remainingBytes);
-        writer_(output.data(), n);
-        remainingBytes -= n;
+        auto stop = output.size();
+        if (roundTrip_ && nextRoundTrip < roundTripRequests.size())
+            stop = roundTripRequests[nextRoundTrip].offset;
+
+        auto const n = std::min({ stop - offset, result.bytesWritten - written, phaseEnd - written });
+        writer_(output.data() + offset, n);
+        offset += n;
+        written += n;
+
+        if (roundTrip_ && nextRoundTrip < roundTripRequests.size()
+            && offset == roundTripRequests[nextRoundTrip].offset)
+        {
+            roundTrip(roundTripRequests[nextRoundTrip]);
+            ++nextRoundTrip;
+        }
+
+        if (test.phaseSize != 0 && (written == phaseEnd || written == result.bytesWritten))
+        {
+            // Make sure the terminal has processed the whole phase before taking its time.
+            if (roundTrip_)
+                roundTrip({});
+            auto const now = steady_clock::now();
+            result.phases.emplace_back(written - (phaseEnd - phaseSize),
+                                       duration_cast<microseconds>(now - phaseBegin));
+            phaseBegin = now;
+            phaseEnd += phaseSize;
+        }
+
+        if (offset == output.size())
+        {
+            offset = 0;
+            nextRoundTrip = 0;
+        }
     }
+    return unansweredTime;
 }
 
 void Benchmark::runAll()
 {
     auto buffer = std::make_unique<Buffer>(std::min(static_cast<size_t>(64u), testSizeMB_));
+    auto unitCounts = std::vector<size_t> {};
 
     for (auto& test: tests_)
     {
         if (beforeTest_)
             beforeTest_(*test);
 
+        test->units.clear();
+        test->roundTripRequests.clear();
         test->setup(terminalSize_);
 
+        test->prepare(*buffer);
+        if (!buffer->empty())
+        {
+            writer_(buffer->output().data(), buffer->output().size());
+            buffer->clear();
+        }
+
+        // A fill() that did not fit into the buffer is undone, so that its units of work
+        // are not counted for output that is never written.
         while (buffer->good())
+        {
+            auto const size = buffer->size();
+            auto const roundTrips = test->roundTripRequests.size();
+            unitCounts.clear();
+            for (auto const& unit: test->units)
+                unitCounts.push_back(unit.count);
+
             test->fill(*buffer);
 
+            if (buffer->dropped() && size != 0)
+            {
+                buffer->truncate(size);
+                test->roundTripRequests.resize(roundTrips);
+                test->units.resize(unitCounts.size());
+                for (size_t i = 0; i < unitCounts.size(); ++i)
+                    test->units[i].count = unitCounts[i];
+                break;
+            }
+        }
+
+        auto result = Result { .test = *test,
+                               .time = {},
+                               .bytesWritten = test->totalSize != 0 ? test->totalSize : totalSizeBytes() };
+
+        // The buffer is written repeatedly until the test size is reached,
+        // so scale the units of work accordingly.
+        auto const repetitions = double(result.bytesWritten) / double(buffer->size());
+        result.unitsWritten = test->units;
+        for (auto& unit: result.unitsWritten)
+            unit.count = static_cast<size_t>(double(unit.count) * repetitions);
+
+        if (environmentProbe_)
+            result.environment = environmentProbe_();
+
+        if (calibrationWriter_)
+        {
+            // The same output without a terminal, and without waiting for one, is the harness' own cost.
+            auto const writer = std::exchange(writer_, calibrationWriter_);
+            auto const roundTrip = std::exchange(roundTrip_, {});
+            auto calibration = Result { .test = *test, .time = {}, .bytesWritten = result.bytesWritten };
+            auto const calibrationBeginTime = steady_clock::now();
+            writeOutput(*buffer, *test, calibration);
+            result.harnessTime = duration_cast<microseconds>(steady_clock::now() - calibrationBeginTime);
+            writer_ = writer;
+            roundTrip_ = roundTrip;
+        }
+
         auto const beginTime = steady_clock::now();
-        writeOutput(*buffer);
+        auto const unansweredTime = writeOutput(*buffer, *test, result);
         buffer->clear();
-        auto const diff = duration_cast<milliseconds>(steady_clock::now() - beginTime);
+        result.time = duration_cast<milliseconds>(steady_clock::now() - beginTime - unansweredTime);
 
-        results_.emplace_back(*test, diff, totalSizeBytes());
+        results_.emplace_back(std::move(result));
 
         test->teardown(*buffer);
         if (!buffer->empty())
@@ -130,6 +279,47 @@ void Benchmark::summarize(std::ostream& os)
                           result.time.count() % 1000,
                           sizeStr(bps),
                           sizeStr(bps / static_cast<double>(gridCellCount)));
+        for (auto const& unit: result.unitsWritten)
+        {
+            os << std::format("{:>40}  {:.0f} {}/s ({} total)\n",
+                              "",
+                              result.perSecond(double(unit.count)),
+                              unit.name,
+                              unit.count);
+            if (unit.name == test.averageTimeUnit && unit.count != 0)
+                os << std::format("{:>40}  {:.3f} ms average time per unit ({})\n",
+                                  "",
+                                  double(result.time.count()) / double(unit.count),
+                                  unit.name);
+        }
+        if (!result.roundTrips.empty())
+        {
+            auto const total =
+                std::accumulate(result.roundTrips.begin(), result.roundTrips.end(), microseconds {});
+            auto const longest = *std::max_element(result.roundTrips.begin(), result.roundTrips.end());
+            os << std::format("{:>40}  {} DA1 round trips, {:.3f} ms average, {:.3f} ms max\n",
+                              "",
+                              result.roundTrips.size(),
+                              double(total.count()) / double(result.roundTrips.size()) / 1000.0,
+                              double(longest.count()) / 1000.0);
+        }
+        for (size_t i = 0; i < result.phases.size(); ++i)
+            os << std::format("{:>40}  phase {:>3}: {}/s\n",
+                              "",
+                              i + 1,
+                              sizeStr(result.phases[i].megabytesPerSecond() * 1024 * 1024));
+        if (result.harnessTime)
+            os << std::format("{:>40}  harness: {:.3f} ms, {}/s without it\n",
+                              "",
+                              double(result.harnessTime->count()) / 1000.0,
+                              sizeStr(result.terminalBytesPerSecond()));
+        if (!result.environment.empty())
+        {
+            auto environment = std::string {};
+            for (auto const& [name, value]: result.environment)
+                environment += std::format("{}{}: {}", environment.empty() ? "" : ", ", name, value);
+            os << std::format("{:>40}  {}\n", "", environment);
+        }
     }
 
     auto const bps = double(totalBytes) / (double(totalTime.count()) / 1000.0);
@@ -144,6 +334,415 @@ void Benchmark::summarize(std::ostream& os)
     os << std::format("   data size: {}\n", sizeStr(static_cast<double>(testSizeMB_ * 1024 * 1024)));
 }
 
+void summarizeSweep(std::ostream& os, std::vector<Benchmark> const& benchmarks)
+{
+    if (benchmarks.empty())
+        return;
+
+    os << std::format("{:>40}", "");
+    for (auto const& benchmark: benchmarks)
+    {
+        auto const terminalSize = benchmark.terminalSize();
+        os << std::format(" | {:^32}", std::format("{}x{}", terminalSize.columns, terminalSize.lines));
+    }
+    os << "\n";
+
+    // The sizes may not all run the same tests, so the rows are matched by test name.
+    auto names = std::vector<std::string_view> {};
+    for (auto const& benchmark: benchmarks)
+        for (auto const& result: benchmark.results())
+            if (std::ranges::find(names, result.test.get().name) == names.end())
+                names.emplace_back(result.test.get().name);
+
+    for (auto const name: names)
+    {
+        os << std::format("{:>40}", name);
+        for (auto const& benchmark: benchmarks)
+        {
+            auto const i = std::ranges::find_if(
+                benchmark.results(), [&](Result const& result) { return result.test.get().name == name; });
+            if (i == benchmark.results().end())
+            {
+                os << std::format(" | {:^32}", "");
+                continue;
+            }
+            auto const& result = *i;
+            auto const gridCellCount = benchmark.terminalSize().columns * benchmark.terminalSize().lines;
+            auto const bps = result.perSecond(double(result.bytesWritten));
+            os << std::format(" | {:^32}",
+                              std::format("{}/s ({}/s)",
+                                          sizeStr(bps),
+                                          sizeStr(bps / static_cast<double>(gridCellCount))));
+        }
+        os << "\n";
+    }
+}
+
+void summarizeSweepToJson(std::ostream& os, std::vector<Benchmark> const& benchmarks)
+{
+    os << "[";
+    for (auto const& benchmark: benchmarks)
+    {
+        if (&benchmark != &benchmarks.front())
+            os << ",";
+        os << std::format(R"({{"columns":{},"lines":{},"results":)",
+                          benchmark.terminalSize().columns,
+                          benchmark.terminalSize().lines);
+        os << glz::write_json(benchmark.results()).value_or("error");
+        os << "}";
+    }
+    os << "]";
+}
+
+namespace
+{
+    auto constexpr WorkloadModelMagic = "TBWM"sv;
+    auto constexpr WorkloadModelVersion = 1u;
+    auto constexpr MaxWorkloadModelOrder = 64u;
+
+    using ChainCounts = std::map<std::vector<uint32_t>, std::map<uint32_t, uint64_t>>;
+
+    bool isTextByte(char ch) noexcept
+    {
+        auto const byte = static_cast<unsigned char>(ch);
+        return byte >= 0x20 && byte != 0x7F;
+    }
+
+    bool isInRange(char ch, unsigned char first, unsigned char last) noexcept
+    {
+        auto const byte = static_cast<unsigned char>(ch);
+        return byte >= first && byte <= last;
+    }
+
+    /// Returns the length of the text run, control character or escape sequence that @p input begins with.
+    size_t tokenLength(std::string_view input) noexcept
+    {
+        if (isTextByte(input[0]))
+        {
+            size_t n = 1;
+            while (n < input.size() && isTextByte(input[n]))
+                ++n;
+            return n;
+        }
+
+        if (input[0] != '\033' || input.size() == 1)
+            return 1;
+
+        switch (input[1])
+        {
+            case '[': {
+                // Parameter and intermediate bytes, followed by the final byte.
+                size_t n = 2;
+                while (n < input.size() && isInRange(input[n], 0x20, 0x3F))
+                    ++n;
+                return n < input.size() && isInRange(input[n], 0x40, 0x7E) ? n + 1 : n;
+            }
+            case ']':
+            case 'P':
+            case 'X':
+            case '^':
+            case '_':
+                // Control strings, terminated by BEL or ST, or aborted by another escape sequence.
+                for (size_t n = 2; n < input.size(); ++n)
+                {
+                    if (input[n] == '\a')
+                        return n + 1;
+                    if (input[n] == '\033')
+                        return n + 1 < input.size() && input[n + 1] == '\\' ? n + 2 : n;
+                }
+                return input.size();
+            default: {
+                size_t n = 1;
+                while (n < input.size() && isInRange(input[n], 0x20, 0x2F))
+                    ++n;
+                return std::min(n + 1, input.size());
+            }
+        }
+    }
+
+    /// Rounds long text runs to their 6 most significant bits, so that they do not bloat the model.
+    size_t roundTextLength(size_t length) noexcept
+    {
+        if (length < 256)
+            return length;
+        return length & ~((size_t { 1 } << (std::bit_width(length) - 6)) - 1);
+    }
+
+    size_t utf8Length(char lead) noexcept
+    {
+        auto const byte = static_cast<unsigned char>(lead);
+        if (byte >= 0xF0 && byte <= 0xF7)
+            return 4;
+        if (byte >= 0xE0)
+            return 3;
+        if (byte >= 0xC0)
+            return 2;
+        return 1;
+    }
+
+    /// Assigns indices to the states and links every successor to the state that follows it.
+    /// Fails if a successor leads to a state that has not been observed.
+    std::optional<std::vector<WorkloadModel::State>> linkStates(ChainCounts const& counts)
+    {
+        std::map<std::vector<uint32_t>, uint32_t> indices;
+        for (auto const& [context, successors]: counts)
+            indices.emplace(context, static_cast<uint32_t>(indices.size()));
+
+        std::vector<WorkloadModel::State> states;
+        states.reserve(counts.size());
+        for (auto const& [context, successors]: counts)
+        {
+            auto& state = states.emplace_back(WorkloadModel::State { .context = context });
+            uint64_t cumulativeCount = 0;
+            for (auto const& [token, count]: successors)
+            {
+                auto next = std::vector<uint32_t>(context.begin() + (context.empty() ? 0 : 1), context.end());
+                if (!context.empty())
+                    next.push_back(token);
+                auto const i = indices.find(next);
+                if (i == indices.end())
+                    return std::nullopt;
+                cumulativeCount += count;
+                state.successors.push_back({ token, cumulativeCount, i->second });
+            }
+        }
+        return states;
+    }
+
+    /// Builds an order-N Markov chain of the given sequence. The sequence is treated as cyclic,
+    /// so that every state has at least one successor.
+    std::vector<WorkloadModel::State> buildChain(std::vector<uint32_t> const& sequence, unsigned order)
+    {
+        ChainCounts counts;
+        auto context = std::vector<uint32_t>(order);
+        for (size_t i = 0; i < sequence.size(); ++i)
+        {
+            for (unsigned k = 0; k < order; ++k)
+                context[k] = sequence[(i + k) % sequence.size()];
+            ++counts[context][sequence[(i + order) % sequence.size()]];
+        }
+        return linkStates(counts).value_or(std::vector<WorkloadModel::State> {});
+    }
+
+    void appendVarint(std::string& output, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            output += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        output += static_cast<char>(value);
+    }
+
+    std::optional<uint64_t> readVarint(std::string_view& input) noexcept
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64 && !input.empty(); shift += 7)
+        {
+            auto const byte = static_cast<unsigned char>(input.front());
+            input.remove_prefix(1);
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        return std::nullopt;
+    }
+
+    void appendBytes(std::string& output, std::string_view bytes)
+    {
+        appendVarint(output, bytes.size());
+        output += bytes;
+    }
+
+    std::optional<std::string> readBytes(std::string_view& input)
+    {
+        auto const size = readVarint(input);
+        if (!size || *size > input.size())
+            return std::nullopt;
+        auto bytes = std::string(input.substr(0, static_cast<size_t>(*size)));
+        input.remove_prefix(static_cast<size_t>(*size));
+        return bytes;
+    }
+
+    void appendChain(std::string& output, std::vector<WorkloadModel::State> const& states)
+    {
+        // The context length is implied by the order, and counts are stored as deltas to keep them small.
+        appendVarint(output, states.size());
+        for (auto const& state: states)
+        {
+            for (auto const token: state.context)
+                appendVarint(output, token);
+            appendVarint(output, state.successors.size());
+            uint64_t previousCount = 0;
+            for (auto const& successor: state.successors)
+            {
+                appendVarint(output, successor.token);
+                appendVarint(output, successor.cumulativeCount - previousCount);
+                previousCount = successor.cumulativeCount;
+            }
+        }
+    }
+
+    std::optional<std::vector<WorkloadModel::State>> readChain(std::string_view& input,
+                                                               unsigned order,
+                                                               size_t alphabetSize)
+    {
+        auto const readToken = [&]() -> std::optional<uint32_t> {
+            auto const token = readVarint(input);
+            if (!token || *token >= alphabetSize)
+                return std::nullopt;
+            return static_cast<uint32_t>(*token);
+        };
+
+        auto const stateCount = readVarint(input);
+        if (!stateCount)
+            return std::nullopt;
+
+        ChainCounts counts;
+        for (uint64_t i = 0; i < *stateCount; ++i)
+        {
+            auto context = std::vector<uint32_t>(order);
+            for (auto& token: context)
+            {
+                auto const value = readToken();
+                if (!value)
+                    return std::nullopt;
+                token = *value;
+            }
+
+            auto const successorCount = readVarint(input);
+            if (!successorCount || *successorCount == 0)
+                return std::nullopt;
+            auto& successors = counts[context];
+            for (uint64_t k = 0; k < *successorCount; ++k)
+            {
+                auto const token = readToken();
+                auto const count = readVarint(input);
+                if (!token || !count || *count == 0)
+                    return std::nullopt;
+                successors[*token] += *count;
+            }
+        }
+        return linkStates(counts);
+    }
+} // namespace
+
+WorkloadModel trainWorkloadModel(std::string_view capture, unsigned order)
+{
+    auto model = WorkloadModel { .order = std::min(order, MaxWorkloadModelOrder) };
+
+    std::map<std::pair<size_t, std::string_view>, uint32_t> tokenIndices;
+    std::map<std::string_view, uint32_t> characterIndices;
+    std::vector<uint32_t> tokens;
+    std::vector<uint32_t> characters;
+    while (!capture.empty())
+    {
+        auto const bytes = capture.substr(0, tokenLength(capture));
+        capture.remove_prefix(bytes.size());
+
+        auto key = std::pair { size_t { 0 }, bytes };
+        if (isTextByte(bytes.front()))
+        {
+            key = { roundTextLength(bytes.size()), std::string_view {} };
+            for (size_t i = 0; i < bytes.size();)
+            {
+                auto const character = bytes.substr(i, std::min(utf8Length(bytes[i]), bytes.size() - i));
+                auto const [entry, inserted] =
+                    characterIndices.try_emplace(character, static_cast<uint32_t>(model.characters.size()));
+                if (inserted)
+                    model.characters.emplace_back(character);
+                characters.push_back(entry->second);
+                i += character.size();
+            }
+        }
+
+        auto const [entry, inserted] =
+            tokenIndices.try_emplace(key, static_cast<uint32_t>(model.tokens.size()));
+        if (inserted)
+            model.tokens.push_back({ .bytes = std::string(key.second), .textLength = key.first });
+        tokens.push_back(entry->second);
+    }
+
+    model.states = buildChain(tokens, model.order);
+    model.characterStates = buildChain(characters, 1);
+    return model;
+}
+
+std::string saveWorkloadModel(WorkloadModel const& model)
+{
+    std::string output { WorkloadModelMagic };
+    appendVarint(output, WorkloadModelVersion);
+    appendVarint(output, model.order);
+
+    appendVarint(output, model.tokens.size());
+    for (auto const& token: model.tokens)
+    {
+        appendVarint(output, token.textLength);
+        appendBytes(output, token.bytes);
+    }
+
+    appendVarint(output, model.characters.size());
+    for (auto const& character: model.characters)
+        appendBytes(output, character);
+
+    appendChain(output, model.states);
+    appendChain(output, model.characterStates);
+    return output;
+}
+
+bool isWorkloadModel(std::string_view data) noexcept
+{
+    return data.starts_with(WorkloadModelMagic);
+}
+
+std::optional<WorkloadModel> loadWorkloadModel(std::string_view data)
+{
+    if (!isWorkloadModel(data))
+        return std::nullopt;
+    data.remove_prefix(WorkloadModelMagic.size());
+
+    auto const version = readVarint(data);
+    auto const order = readVarint(data);
+    if (version != WorkloadModelVersion || !order || *order > MaxWorkloadModelOrder)
+        return std::nullopt;
+
+    auto model = WorkloadModel { .order = static_cast<unsigned>(*order) };
+
+    auto const tokenCount = readVarint(data);
+    if (!tokenCount)
+        return std::nullopt;
+    bool hasText = false;
+    for (uint64_t i = 0; i < *tokenCount; ++i)
+    {
+        auto const textLength = readVarint(data);
+        auto bytes = readBytes(data);
+        if (!textLength || *textLength > std::numeric_limits<uint32_t>::max() || !bytes
+            || (*textLength == 0 && bytes->empty()))
+            return std::nullopt;
+        hasText = hasText || *textLength != 0;
+        model.tokens.push_back({ .bytes = std::move(*bytes), .textLength = static_cast<size_t>(*textLength) });
+    }
+
+    auto const characterCount = readVarint(data);
+    if (!characterCount)
+        return std::nullopt;
+    for (uint64_t i = 0; i < *characterCount; ++i)
+    {
+        auto character = readBytes(data);
+        if (!character || character->empty())
+            return std::nullopt;
+        model.characters.emplace_back(std::move(*character));
+    }
+
+    auto states = readChain(data, model.order, model.tokens.size());
+    auto characterStates = readChain(data, 1, model.characters.size());
+    if (!states || !characterStates || !data.empty() || (hasText && characterStates->empty()))
+        return std::nullopt;
+    model.states = std::move(*states);
+    model.characterStates = std::move(*characterStates);
+    return model;
+}
+
 } // namespace termbench
 
 namespace termbench::tests
@@ -242,150 +841,2003 @@ namespace
         writeChar(_sink, 'm');
     }
 
-    class CraftedTest: public Test
+    /// Seedable variant of the Knuth MMIX generator used by randomAsciiChar(),
+    /// so that tests can produce reproducible pseudo random workloads.
+    class Random
     {
       public:
-        explicit CraftedTest(std::string name, std::string description, std::string text) noexcept:
-            Test(std::move(name), std::move(description)), _text { std::move(text) }
+        explicit Random(uint64_t seed) noexcept: _state { seed } {}
+
+        uint64_t next() noexcept
         {
+            _state = _state * 6364136223846793005 + 1442695040888963407;
+            return _state;
         }
 
-        void fill(Buffer& _sink) noexcept override { _sink.write(_text); }
+        /// Returns a value in the closed range [min, max].
+        unsigned between(unsigned min, unsigned max) noexcept
+        {
+            // The high bits of an LCG have a much longer period than the low ones.
+            return min + static_cast<unsigned>((next() >> 33) % (max - min + 1));
+        }
 
       private:
-        std::string _text;
+        uint64_t _state;
     };
 
-    class ManyLines: public Test
+    auto constexpr DefaultSeed = uint64_t { 1442695040888963407 };
+
+    /// Same characters as randomAsciiChar(), but drawn from the test's own generator, so that the output
+    /// does not depend on which tests ran before.
+    char randomAsciiChar(Random& random) noexcept
     {
-      public:
-        ManyLines() noexcept: Test("many_lines", "") {}
+        return static_cast<char>('a' + random.between(0, 'z' - 'a'));
+    }
 
-        void setup(TerminalSize) override
+    void writeRandomText(Buffer& _sink, Random& random, size_t count)
+    {
+        char buffer[256];
+        while (count > 0)
         {
-            text.resize(4 * 1024 * 1024);
-            for (auto i = text.data(), e = i + text.size(); i != e; ++i)
-            {
-                char const value = randomAsciiChar();
-                if (value % 26 != 0)
-                    *i = value;
-                else
-                    *i = '\n';
-            }
+            auto const n = std::min(count, sizeof(buffer));
+            for (size_t i = 0; i < n; ++i)
+                buffer[i] = randomAsciiChar(random);
+            _sink.write(std::string_view { buffer, n });
+            count -= n;
         }
+    }
 
-        void fill(Buffer& _sink) noexcept override { _sink.write(text); }
+    void writeCSI(Buffer& _sink, std::initializer_list<unsigned> parameters, std::string_view final)
+    {
+        _sink.write("\033[");
+        for (auto i = parameters.begin(); i != parameters.end(); ++i)
+        {
+            if (i != parameters.begin())
+                writeChar(_sink, ';');
+            writeNumber(_sink, *i);
+        }
+        _sink.write(final);
+    }
 
-      private:
-        std::string text;
-    };
+    // Assumed pixel size of a single grid cell, used to scale images to the terminal size.
+    auto constexpr CellWidthPixels = 10u;
+    auto constexpr CellHeightPixels = 20u;
 
-    class LongLines: public Test
+    struct RGB
     {
-      public:
-        LongLines() noexcept: Test("long_lines", "") {}
+        uint8_t r;
+        uint8_t g;
+        uint8_t b;
+    };
 
-        void fill(Buffer& _sink) noexcept override { writeChar(_sink, randomAsciiChar()); }
+    /// A palette based image, as produced by createImage().
+    struct IndexedImage
+    {
+        unsigned width = 0;
+        unsigned height = 0;
+        std::vector<RGB> palette {};
+        std::vector<uint8_t> pixels {}; // palette indices, row by row
     };
 
-    class SgrFgColoredText: public Test
+    RGB mix(RGB a, RGB b, double t) noexcept
     {
-      public:
-        SgrFgColoredText() noexcept: Test("sgr_fg_lines", "") {}
+        auto const lerp = [t](uint8_t x, uint8_t y) {
+            return static_cast<uint8_t>(x + (y - x) * t);
+        };
+        return { lerp(a.r, b.r), lerp(a.g, b.g), lerp(a.b, b.b) };
+    }
 
-        TerminalSize terminalSize;
-        unsigned frameID = 0;
+    RGB randomColor(Random& random) noexcept
+    {
+        auto const v = random.next() >> 40;
+        return { static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v >> 16) };
+    }
 
-        void setup(TerminalSize size) noexcept override { terminalSize = size; }
+    /// Creates a deterministic procedural image of the given pattern with up to 256 colors.
+    IndexedImage createImage(
+        ImagePattern pattern, unsigned colorCount, unsigned width, unsigned height, uint64_t seed)
+    {
+        auto random = Random { seed };
+        colorCount = std::clamp(colorCount, 2u, 256u);
 
-        void fill(Buffer& _sink) noexcept override
+        auto image = IndexedImage { .width = width, .height = height };
+        image.palette.reserve(colorCount);
+        image.pixels.resize(size_t { width } * height);
+
+        switch (pattern)
         {
-            ++frameID;
-            for (u16 y = 0; y < terminalSize.lines; ++y)
-            {
-                moveCursor(_sink, 1, y + 1u);
-                for (u16 x = 0; x < terminalSize.columns; ++x)
+            case ImagePattern::Gradient: {
+                auto const from = randomColor(random);
+                auto const to = randomColor(random);
+                for (unsigned i = 0; i < colorCount; ++i)
+                    image.palette.push_back(mix(from, to, double(i) / (colorCount - 1)));
+                for (unsigned y = 0; y < height; ++y)
+                    for (unsigned x = 0; x < width; ++x)
+                        image.pixels[y * width + x] =
+                            static_cast<uint8_t>((x * colorCount / width + y * colorCount / height) / 2);
+                break;
+            }
+            case ImagePattern::Noise: {
+                for (unsigned i = 0; i < colorCount; ++i)
+                    image.palette.push_back(randomColor(random));
+                for (auto& pixel: image.pixels)
+                    pixel = static_cast<uint8_t>(random.between(0, colorCount - 1));
+                break;
+            }
+            case ImagePattern::Photo: {
+                // A ramp through a few random anchor colors, indexed by overlapping waves and a little noise,
+                // which gives the smooth areas and soft edges of natural images.
+                RGB const anchors[] = { randomColor(random), randomColor(random), randomColor(random) };
+                for (unsigned i = 0; i < colorCount; ++i)
                 {
-                    auto const r = frameID;
-                    auto const g = frameID + y;
-                    auto const b = frameID + y + x;
-
-                    setTextColor(_sink, r & 0xff, g & 0xff, b & 0xff);
-                    writeChar(_sink, static_cast<char>('a' + (frameID + x + y) % ('z' - 'a')));
+                    auto const t = 2.0 * i / (colorCount - 1);
+                    image.palette.push_back(t < 1.0 ? mix(anchors[0], anchors[1], t)
+                                                    : mix(anchors[1], anchors[2], t - 1.0));
+                }
+                double frequencies[3];
+                double phases[3];
+                for (auto i = 0; i < 3; ++i)
+                {
+                    frequencies[i] = 0.002 + double(random.between(1, 1000)) / 50000.0;
+                    phases[i] = double(random.between(0, 628)) / 100.0;
+                }
+                for (unsigned y = 0; y < height; ++y)
+                {
+                    for (unsigned x = 0; x < width; ++x)
+                    {
+                        auto v = std::sin(x * frequencies[0] + phases[0])
+                                 + std::sin(y * frequencies[1] + phases[1])
+                                 + std::sin((x + y) * frequencies[2] + phases[2]);
+                        v = (v + 3.0) / 6.0 + double(random.between(0, 100)) / 5000.0;
+                        image.pixels[y * width + x] =
+                            static_cast<uint8_t>(std::clamp(v * colorCount, 0.0, double(colorCount - 1)));
+                    }
                 }
+                break;
             }
         }
-    };
+        return image;
+    }
 
-    class SgrFgBgColoredText: public Test
+    void appendNumber(std::string& output, unsigned value)
     {
-      public:
-        SgrFgBgColoredText() noexcept: Test("sgr_fg_bg_lines", "") {}
+        char buffer[16];
+        auto const result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+        output.append(buffer, result.ptr);
+    }
+
+    /// Encodes the image as a Sixel DCS sequence, run-length encoding each color of each six pixel high band.
+    std::string encodeSixel(IndexedImage const& image)
+    {
+        std::string output = "\033Pq\"1;1;";
+        appendNumber(output, image.width);
+        output += ';';
+        appendNumber(output, image.height);
+
+        for (unsigned i = 0; i < image.palette.size(); ++i)
+        {
+            auto const& color = image.palette[i];
+            output += '#';
+            appendNumber(output, i);
+            output += ";2;";
+            appendNumber(output, color.r * 100u / 255u);
+            output += ';';
+            appendNumber(output, color.g * 100u / 255u);
+            output += ';';
+            appendNumber(output, color.b * 100u / 255u);
+        }
+
+        auto const writeRun = [&](char sixel, unsigned count) {
+            if (count > 3)
+            {
+                output += '!';
+                appendNumber(output, count);
+                output += sixel;
+            }
+            else
+                output.append(count, sixel);
+        };
+
+        auto bands = std::vector<uint8_t>(image.palette.size() * image.width);
+        auto used = std::vector<bool>(image.palette.size());
+        for (unsigned top = 0; top < image.height; top += 6)
+        {
+            std::fill(bands.begin(), bands.end(), uint8_t { 0 });
+            std::fill(used.begin(), used.end(), false);
+            for (unsigned row = 0; row < 6 && top + row < image.height; ++row)
+            {
+                for (unsigned x = 0; x < image.width; ++x)
+                {
+                    auto const index = image.pixels[(top + row) * image.width + x];
+                    bands[index * image.width + x] |= static_cast<uint8_t>(1 << row);
+                    used[index] = true;
+                }
+            }
+
+            auto first = true;
+            for (unsigned color = 0; color < image.palette.size(); ++color)
+            {
+                if (!used[color])
+                    continue;
+                if (!first)
+                    output += '$';
+                first = false;
+
+                output += '#';
+                appendNumber(output, color);
+                auto const* bits = &bands[color * image.width];
+                auto end = image.width;
+                while (end > 0 && bits[end - 1] == 0)
+                    --end;
+                unsigned x = 0;
+                while (x < end)
+                {
+                    auto runEnd = x + 1;
+                    while (runEnd < end && bits[runEnd] == bits[x])
+                        ++runEnd;
+                    writeRun(static_cast<char>('?' + bits[x]), runEnd - x);
+                    x = runEnd;
+                }
+            }
+            output += '-';
+        }
+        output += "\033\\";
+        return output;
+    }
+
+    /// Returns the raw RGB or RGBA pixels of a rectangular area of the image.
+    std::string rawPixels(
+        IndexedImage const& image, bool alpha, unsigned left, unsigned top, unsigned width, unsigned height)
+    {
+        std::string output;
+        output.reserve(size_t { width } * height * (alpha ? 4 : 3));
+        for (auto y = top; y < top + height; ++y)
+        {
+            for (auto x = left; x < left + width; ++x)
+            {
+                auto const index = image.pixels[y * image.width + x];
+                auto const& color = image.palette[index];
+                output += static_cast<char>(color.r);
+                output += static_cast<char>(color.g);
+                output += static_cast<char>(color.b);
+                if (alpha)
+                    output += static_cast<char>(255 - index / 2);
+            }
+        }
+        return output;
+    }
+
+    void appendBase64(std::string& output, std::string_view data)
+    {
+        static constexpr auto alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        output.reserve(output.size() + (data.size() + 2) / 3 * 4);
+        size_t i = 0;
+        for (; i + 2 < data.size(); i += 3)
+        {
+            auto const v = unsigned(uint8_t(data[i])) << 16 | unsigned(uint8_t(data[i + 1])) << 8
+                           | unsigned(uint8_t(data[i + 2]));
+            output += alphabet[(v >> 18) & 0x3F];
+            output += alphabet[(v >> 12) & 0x3F];
+            output += alphabet[(v >> 6) & 0x3F];
+            output += alphabet[v & 0x3F];
+        }
+        if (i < data.size())
+        {
+            auto v = unsigned(uint8_t(data[i])) << 16;
+            if (i + 1 < data.size())
+                v |= unsigned(uint8_t(data[i + 1])) << 8;
+            output += alphabet[(v >> 18) & 0x3F];
+            output += alphabet[(v >> 12) & 0x3F];
+            output += i + 1 < data.size() ? alphabet[(v >> 6) & 0x3F] : '=';
+            output += '=';
+        }
+    }
+
+    /// Appends a kitty graphics command, splitting the base64 encoded payload into chunks
+    /// of at most chunkSize bytes that are continued with m=1.
+    void appendKittyCommand(std::string& output,
+                            std::string_view control,
+                            std::string_view data,
+                            size_t chunkSize)
+    {
+        std::string payload;
+        appendBase64(payload, data);
+
+        chunkSize = std::max<size_t>(chunkSize / 4 * 4, 4);
+        auto const chunkCount = std::max<size_t>((payload.size() + chunkSize - 1) / chunkSize, 1);
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            output += "\033_G";
+            if (i == 0)
+            {
+                output += control;
+                output += ',';
+            }
+            output += i + 1 < chunkCount ? "m=1;" : "m=0;";
+            output += std::string_view(payload).substr(i * chunkSize, chunkSize);
+            output += "\033\\";
+        }
+    }
+
+    void appendBigEndian(std::string& output, uint32_t value)
+    {
+        output += static_cast<char>(value >> 24);
+        output += static_cast<char>(value >> 16);
+        output += static_cast<char>(value >> 8);
+        output += static_cast<char>(value);
+    }
+
+    uint32_t crc32(std::string_view data) noexcept
+    {
+        static auto const table = [] {
+            std::array<uint32_t, 256> result {};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                auto c = i;
+                for (auto k = 0; k < 8; ++k)
+                    c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+                result[i] = c;
+            }
+            return result;
+        }();
+
+        auto crc = 0xFFFFFFFFu;
+        for (auto const ch: data)
+            crc = table[(crc ^ uint8_t(ch)) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    /// Encodes the image as an RGB PNG file, using uncompressed deflate blocks so that no zlib is needed.
+    std::string encodePng(IndexedImage const& image)
+    {
+        std::string scanlines;
+        for (unsigned y = 0; y < image.height; ++y)
+        {
+            scanlines += '\0'; // filter type: none
+            scanlines += rawPixels(image, false, 0, y, image.width, 1);
+        }
+
+        std::string zlib = "\x78\x01";
+        uint32_t a = 1;
+        uint32_t b = 0;
+        for (auto const ch: scanlines)
+        {
+            a = (a + uint8_t(ch)) % 65521;
+            b = (b + a) % 65521;
+        }
+        for (size_t offset = 0; offset < scanlines.size(); offset += 0xFFFF)
+        {
+            auto const block = std::string_view(scanlines).substr(offset, 0xFFFF);
+            auto const length = static_cast<uint16_t>(block.size());
+            zlib += static_cast<char>(offset + block.size() == scanlines.size() ? 1 : 0);
+            zlib += static_cast<char>(length);
+            zlib += static_cast<char>(length >> 8);
+            zlib += static_cast<char>(~length);
+            zlib += static_cast<char>(~length >> 8);
+            zlib += block;
+        }
+        appendBigEndian(zlib, b << 16 | a);
+
+        auto output = std::string { "\x89PNG\r\n\x1A\n" };
+        auto const appendChunk = [&](std::string_view type, std::string_view data) {
+            appendBigEndian(output, static_cast<uint32_t>(data.size()));
+            auto const start = output.size();
+            output += type;
+            output += data;
+            appendBigEndian(output, crc32(std::string_view(output).substr(start)));
+        };
+
+        std::string header;
+        appendBigEndian(header, image.width);
+        appendBigEndian(header, image.height);
+        header += "\x08\x02\x00\x00\x00"sv; // 8 bit RGB, deflate, no filter, no interlace
+        appendChunk("IHDR", header);
+        appendChunk("IDAT", zlib);
+        appendChunk("IEND", {});
+        return output;
+    }
+
+    // {{{ complex script word lists
+    constexpr std::string_view ArabicWords[] = {
+        "مرحبا", "السلام", "عليكم", "كتاب",  "مدرسة", "الحاسوب", "برنامج", "العربية", "لغة",  "جميلة", "شمس",
+        "قمر",   "بيت",    "الطريق", "سريع", "مفتاح", "نافذة",   "ملف",    "خطأ",     "تحديث", "كَتَبَ", "مُحَمَّد",
+    };
+
+    constexpr std::string_view HebrewWords[] = {
+        "שלום", "עולם", "מחשב", "תוכנה", "ספר", "בית",  "שפה",  "עברית",  "חלון",
+        "קובץ", "שגיאה", "עדכון", "מהיר",  "דרך", "שמש", "ירח", "שָׁלוֹם", "בְּרֵאשִׁית",
+    };
+
+    // Left-to-right runs embedded into right-to-left text, as found in logs and chat messages.
+    constexpr std::string_view LatinWords[] = {
+        "terminal", "file.txt", "v2.0", "OK", "CPU", "2024", "https://example.org", "(42)", "3.14", "GPU",
+    };
+
+    constexpr std::string_view DevanagariWords[] = {
+        "नमस्ते", "क्षत्रिय", "विद्यालय", "संस्कृत",  "प्रश्न", "ज्ञान", "हिन्दी", "भाषा",
+        "कम्प्यूटर", "स्वतंत्रता", "द्वार",   "शुद्ध", "श्री",   "त्रुटि",  "फ़ाइल", "अद्यतन",
+    };
+
+    constexpr std::string_view BengaliWords[] = {
+        "নমস্কার", "বাংলা", "ভাষা", "কম্পিউটার", "বিদ্যালয়", "স্বাধীনতা", "প্রশ্ন",
+        "জ্ঞান",   "ক্ষমা", "শ্রী",  "যুক্ত",     "রাষ্ট্র",   "সন্ধ্যা",    "ত্রুটি",
+    };
+
+    constexpr std::string_view ThaiWords[] = {
+        "สวัสดี", "ภาษาไทย", "คอมพิวเตอร์", "โปรแกรม", "หน้าต่าง", "แฟ้ม",    "ข้อผิดพลาด", "ปรับปรุง", "รวดเร็ว",
+        "ถนน",  "ดวงอาทิตย์", "พระจันทร์", "บ้าน",    "หนังสือ",  "โรงเรียน", "ที่",        "และ",     "เป็น",
+    };
+    // }}}
+
+    char32_t decodeUtf8(std::string_view text, size_t& i) noexcept
+    {
+        auto const lead = uint8_t(text[i++]);
+        auto const length = lead < 0x80 ? 0 : lead < 0xE0 ? 1 : lead < 0xF0 ? 2 : 3;
+        auto codepoint = char32_t(length == 0 ? lead : lead & (0x3F >> length));
+        for (auto k = 0; k < length && i < text.size(); ++k)
+            codepoint = (codepoint << 6) | (uint8_t(text[i++]) & 0x3F);
+        return codepoint;
+    }
+
+    /// Tells whether the codepoint is a nonspacing mark (or joiner) of the scripts used by the tests,
+    /// which does not occupy a grid cell on its own.
+    bool isNonspacing(char32_t codepoint) noexcept
+    {
+        static constexpr std::pair<char32_t, char32_t> ranges[] = {
+            { 0x0591, 0x05BD }, { 0x05BF, 0x05BF }, { 0x05C1, 0x05C2 }, { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 },
+            { 0x0610, 0x061A }, { 0x064B, 0x065F }, { 0x0670, 0x0670 }, { 0x06D6, 0x06DC }, { 0x06DF, 0x06E4 },
+            { 0x0900, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C }, { 0x0941, 0x0948 }, { 0x094D, 0x094D },
+            { 0x0951, 0x0957 }, { 0x0962, 0x0963 }, { 0x0981, 0x0981 }, { 0x09BC, 0x09BC }, { 0x09C1, 0x09C4 },
+            { 0x09CD, 0x09CD }, { 0x09E2, 0x09E3 }, { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E },
+            { 0x200C, 0x200D },
+        };
+        for (auto const& [first, last]: ranges)
+            if (first <= codepoint && codepoint <= last)
+                return true;
+        return false;
+    }
+
+    /// Returns the number of grid cells the (narrow) text occupies.
+    size_t columnWidth(std::string_view text) noexcept
+    {
+        size_t width = 0;
+        for (size_t i = 0; i < text.size();)
+            if (!isNonspacing(decodeUtf8(text, i)))
+                ++width;
+        return width;
+    }
+
+    /// Returns the longest prefix of the (narrow) text that occupies at most the given number of grid cells,
+    /// including the nonspacing marks of its last character.
+    std::string_view columnPrefix(std::string_view text, size_t columns) noexcept
+    {
+        size_t width = 0;
+        size_t end = 0;
+        for (size_t i = 0; i < text.size();)
+        {
+            if (!isNonspacing(decodeUtf8(text, i)) && ++width > columns)
+                break;
+            end = i;
+        }
+        return text.substr(0, end);
+    }
+
+    /// Creates lines of randomly picked words, each padded to lineLength columns.
+    /// Words that are longer than a whole line are cut off at the end of the line.
+    /// If mixedDirection is set, every few words a left-to-right run is embedded.
+    std::string wordLines(std::span<std::string_view const> words,
+                          size_t lineLength,
+                          bool spaceSeparated,
+                          bool mixedDirection)
+    {
+        auto constexpr LineCount = 64;
+
+        auto random = Random { DefaultSeed };
+        std::string text;
+        for (auto line = 0; line < LineCount; ++line)
+        {
+            size_t width = 0;
+            while (true)
+            {
+                auto const word = mixedDirection && random.between(0, 4) == 0
+                                      ? LatinWords[random.between(0, std::size(LatinWords) - 1)]
+                                      : words[random.between(0, static_cast<unsigned>(words.size()) - 1)];
+                auto const separator = spaceSeparated && width != 0 ? 1u : 0u;
+                auto const wordWidth = columnWidth(word);
+                if (width == 0 && wordWidth > lineLength)
+                {
+                    auto const prefix = columnPrefix(word, lineLength);
+                    text += prefix;
+                    width = columnWidth(prefix);
+                    break;
+                }
+                if (width + separator + wordWidth > lineLength)
+                    break;
+                if (separator)
+                    text += ' ';
+                text += word;
+                width += separator + wordWidth;
+            }
+            text.append(lineLength - width, ' ');
+            text += '\n';
+        }
+        return text;
+    }
+
+    void appendUtf8(std::string& output, char32_t codepoint)
+    {
+        if (codepoint < 0x80)
+            output += static_cast<char>(codepoint);
+        else if (codepoint < 0x800)
+        {
+            output += static_cast<char>(0xC0 | (codepoint >> 6));
+            output += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            output += static_cast<char>(0xE0 | (codepoint >> 12));
+            output += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            output += static_cast<char>(0xF0 | (codepoint >> 18));
+            output += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            output += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    struct Grapheme
+    {
+        std::string text;
+        unsigned width;
+    };
+
+    /// Creates a random grapheme cluster, drawn from weighted categories of mixed width Unicode.
+    Grapheme randomGrapheme(Random& random)
+    {
+        static constexpr char32_t People[] = { 0x1F468, 0x1F469, 0x1F466, 0x1F467 };
+        static constexpr char32_t Hands[] = { 0x1F44B, 0x1F44C, 0x1F44D, 0x1F44E, 0x1F44F, 0x1F450, 0x1F64F };
+        static constexpr char32_t TextDefaultEmoji[] = { 0x2600, 0x2601, 0x263A, 0x2764,
+                                                         0x26A0, 0x2708, 0x2744, 0x2B06 };
+
+        auto const pick = [&](auto const& table) {
+            return table[random.between(0, static_cast<unsigned>(std::size(table)) - 1)];
+        };
+
+        auto grapheme = Grapheme {};
+        auto const category = random.between(0, 99);
+        if (category < 40)
+        {
+            // wide CJK ideograph
+            appendUtf8(grapheme.text, random.between(0x4E00, 0x9FFF));
+            grapheme.width = 2;
+        }
+        else if (category < 50)
+        {
+            // halfwidth katakana, possibly with a halfwidth (semi-)voiced sound mark,
+            // which extends the grapheme cluster but still occupies a cell of its own
+            appendUtf8(grapheme.text, random.between(0xFF66, 0xFF9D));
+            grapheme.width = 1;
+            if (random.between(0, 3) == 0)
+            {
+                appendUtf8(grapheme.text, random.between(0xFF9E, 0xFF9F));
+                grapheme.width = 2;
+            }
+        }
+        else if (category < 60)
+        {
+            // ZWJ family sequence of two to four members, with optional skin tones
+            auto const members = random.between(2, 4);
+            for (unsigned i = 0; i < members; ++i)
+            {
+                if (i != 0)
+                    appendUtf8(grapheme.text, 0x200D);
+                appendUtf8(grapheme.text, pick(People));
+                if (random.between(0, 1) == 0)
+                    appendUtf8(grapheme.text, random.between(0x1F3FB, 0x1F3FF));
+            }
+            grapheme.width = 2;
+        }
+        else if (category < 70)
+        {
+            // emoji with skin tone modifier
+            appendUtf8(grapheme.text, pick(Hands));
+            appendUtf8(grapheme.text, random.between(0x1F3FB, 0x1F3FF));
+            grapheme.width = 2;
+        }
+        else if (category < 80)
+        {
+            // text default emoji with VS15 (text presentation) or VS16 (emoji presentation)
+            auto const emojiPresentation = random.between(0, 1) == 1;
+            appendUtf8(grapheme.text, pick(TextDefaultEmoji));
+            appendUtf8(grapheme.text, emojiPresentation ? 0xFE0F : 0xFE0E);
+            grapheme.width = emojiPresentation ? 2 : 1;
+        }
+        else
+        {
+            // latin letter with one to three combining marks
+            grapheme.text += static_cast<char>(random.between('a', 'z'));
+            for (auto i = random.between(1, 3); i > 0; --i)
+                appendUtf8(grapheme.text, random.between(0x0300, 0x036F));
+            grapheme.width = 1;
+        }
+        return grapheme;
+    }
+
+    std::string_view patternName(ImagePattern pattern) noexcept
+    {
+        switch (pattern)
+        {
+            case ImagePattern::Gradient: return "gradient";
+            case ImagePattern::Noise: return "noise";
+            case ImagePattern::Photo: return "photo";
+        }
+        return "unknown";
+    }
+
+    class CraftedTest: public Test
+    {
+      public:
+        explicit CraftedTest(std::string name, std::string description, std::string text) noexcept:
+            Test(std::move(name), std::move(description)), _text { std::move(text) }
+        {
+        }
+
+        void fill(Buffer& _sink) noexcept override { _sink.write(_text); }
+
+      private:
+        std::string _text;
+    };
+
+    /// Writes output synthesized from a model of captured output, see WorkloadModel.
+    class Synthesized: public Test
+    {
+      public:
+        Synthesized(std::string name, WorkloadModel model, uint64_t seed) noexcept:
+            Test(std::move(name), ""), _model { std::move(model) }, _seed { seed }
+        {
+        }
+
+        void setup(TerminalSize) override
+        {
+            _random = Random { _seed };
+            _state = 0;
+            _characterState = 0;
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            _chunk.clear();
+            size_t sequences = 0;
+            while (_chunk.size() < 64 * 1024)
+            {
+                auto const& token = _model.tokens[next(_model.states, _state)];
+                if (token.textLength != 0)
+                    appendText(token.textLength);
+                else
+                {
+                    _chunk += token.bytes;
+                    if (token.bytes.front() == '\033')
+                        ++sequences;
+                }
+            }
+            _sink.write(_chunk);
+            countUnits("sequences", sequences);
+        }
+
+      private:
+        /// Advances the given chain by one step and returns the emitted token or character.
+        uint32_t next(std::vector<WorkloadModel::State> const& states, uint32_t& state) noexcept
+        {
+            auto const& successors = states[state].successors;
+            auto const value = (_random.next() >> 11) % successors.back().cumulativeCount;
+            auto const isBefore = [](uint64_t v, WorkloadModel::Successor const& s) {
+                return v < s.cumulativeCount;
+            };
+            auto const successor = std::upper_bound(successors.begin(), successors.end(), value, isBefore);
+            state = successor->state;
+            return successor->token;
+        }
+
+        void appendText(size_t length)
+        {
+            auto const end = _chunk.size() + length;
+            while (_chunk.size() < end)
+                _chunk += _model.characters[next(_model.characterStates, _characterState)];
+        }
+
+        WorkloadModel _model;
+        uint64_t _seed;
+        Random _random { DefaultSeed };
+        uint32_t _state = 0;
+        uint32_t _characterState = 0;
+        std::string _chunk;
+    };
+
+    class ManyLines: public Test
+    {
+      public:
+        ManyLines() noexcept: Test("many_lines", "") {}
+
+        void setup(TerminalSize) override
+        {
+            text.resize(4 * 1024 * 1024);
+            for (auto i = text.data(), e = i + text.size(); i != e; ++i)
+            {
+                char const value = randomAsciiChar();
+                if (value % 26 != 0)
+                    *i = value;
+                else
+                    *i = '\n';
+            }
+        }
+
+        void fill(Buffer& _sink) noexcept override { _sink.write(text); }
+
+      private:
+        std::string text;
+    };
+
+    class LongLines: public Test
+    {
+      public:
+        LongLines() noexcept: Test("long_lines", "") {}
+
+        void fill(Buffer& _sink) noexcept override { writeChar(_sink, randomAsciiChar()); }
+    };
+
+    class SgrFgColoredText: public Test
+    {
+      public:
+        SgrFgColoredText() noexcept: Test("sgr_fg_lines", "") {}
+
+        TerminalSize terminalSize;
+        unsigned frameID = 0;
+
+        void setup(TerminalSize size) noexcept override { terminalSize = size; }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            ++frameID;
+            for (u16 y = 0; y < terminalSize.lines; ++y)
+            {
+                moveCursor(_sink, 1, y + 1u);
+                for (u16 x = 0; x < terminalSize.columns; ++x)
+                {
+                    auto const r = frameID;
+                    auto const g = frameID + y;
+                    auto const b = frameID + y + x;
+
+                    setTextColor(_sink, r & 0xff, g & 0xff, b & 0xff);
+                    writeChar(_sink, static_cast<char>('a' + (frameID + x + y) % ('z' - 'a')));
+                }
+            }
+        }
+    };
+
+    class SgrFgBgColoredText: public Test
+    {
+      public:
+        SgrFgBgColoredText() noexcept: Test("sgr_fg_bg_lines", "") {}
 
         TerminalSize terminalSize;
         unsigned frameID = 0;
 
-        void setup(TerminalSize size) noexcept override { terminalSize = size; }
+        void setup(TerminalSize size) noexcept override { terminalSize = size; }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            for (u16 y = 0; y < terminalSize.lines; ++y)
+            {
+                moveCursor(_sink, 1, y + 1u);
+                for (u16 x = 0; x < terminalSize.columns; ++x)
+                {
+                    auto r = static_cast<uint8_t>(frameID);
+                    auto g = static_cast<uint8_t>(frameID + y);
+                    auto b = static_cast<uint8_t>(frameID + y + x);
+                    setTextColor(_sink, r, g, b);
+
+                    r = static_cast<uint8_t>(frameID + y + x);
+                    g = static_cast<uint8_t>(frameID + y);
+                    b = static_cast<uint8_t>(frameID);
+                    setBackgroundColor(_sink, r, g, b);
+
+                    writeChar(_sink, static_cast<char>('a' + (frameID + x + y) % ('z' - 'a')));
+                }
+            }
+        }
+    };
+
+    /// Mimics accidentally printing a binary file: uniformly random bytes, C0/C1 control floods,
+    /// malformed UTF-8 and unterminated control sequences, mixed in seeded proportions.
+    class Binary: public Test
+    {
+      public:
+        Binary() noexcept: Test("binary", "") {}
+
+        void setup(TerminalSize) override
+        {
+            auto random = Random { DefaultSeed };
+            text.clear();
+            while (text.size() < 4 * 1024 * 1024)
+            {
+                auto const category = random.between(0, 99);
+                if (category < 40)
+                    appendRandomBytes(random);
+                else if (category < 60)
+                    appendControlFlood(random);
+                else if (category < 80)
+                    appendMalformedUtf8(random);
+                else
+                    appendUnterminatedSequence(random);
+            }
+        }
+
+        void fill(Buffer& _sink) noexcept override { _sink.write(text); }
+
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033c"); }
+
+      private:
+        void appendRandomBytes(Random& random)
+        {
+            for (auto n = random.between(16, 256); n > 0; --n)
+                text += static_cast<char>(random.between(0, 255));
+        }
+
+        void appendControlFlood(Random& random)
+        {
+            for (auto n = random.between(16, 128); n > 0; --n)
+            {
+                switch (random.between(0, 2))
+                {
+                    case 0: {
+                        // C0, but no ESC as that is covered by the unterminated sequences
+                        auto const control = random.between(0, 0x1E);
+                        text += static_cast<char>(control < 0x1B ? control : control + 1);
+                        break;
+                    }
+                    case 1: // raw 8-bit C1
+                        text += static_cast<char>(random.between(0x80, 0x9F));
+                        break;
+                    default: // UTF-8 encoded C1
+                        appendUtf8(text, random.between(0x80, 0x9F));
+                        break;
+                }
+            }
+        }
+
+        void appendMalformedUtf8(Random& random)
+        {
+            static constexpr std::string_view Sequences[] = {
+                "\xC0\x80",         // overlong NUL
+                "\xC1\xBF",         // overlong DEL
+                "\xE0\x80\xAF",     // overlong '/'
+                "\xF0\x80\x80\xAF", // overlong '/'
+                "\xED\xA0\x80",     // UTF-16 surrogate
+                "\xF4\x90\x80\x80", // beyond U+10FFFF
+                "\xE2\x82",         // truncated U+20AC
+                "\xF0\x9F\x94",     // truncated U+1F525
+                "\xF8\x88\x80\x80\x80",
+                "\xFE",
+                "\xFF",
+            };
+
+            for (auto n = random.between(8, 64); n > 0; --n)
+            {
+                if (random.between(0, 3) == 0)
+                    text += static_cast<char>(random.between(0x80, 0xBF)); // lone continuation byte
+                else
+                    text += Sequences[random.between(0, std::size(Sequences) - 1)];
+                if (random.between(0, 1) == 0)
+                    text += randomAsciiChar(random);
+            }
+        }
+
+        void appendUnterminatedSequence(Random& random)
+        {
+            switch (random.between(0, 2))
+            {
+                case 0: text += "\033["; break;
+                case 1: text += "\033]0;"; break;
+                default: text += "\033P1$q"; break;
+            }
+            // Parameters and payload without any final byte or string terminator.
+            for (auto n = random.between(1, 512); n > 0; --n)
+                text += static_cast<char>(random.between(0, 9) == 0 ? ';' : random.between('0', '9'));
+        }
+
+        std::string text;
+    };
+
+    class Line: public Test
+    {
+      public:
+        Line(std::string name, std::string text): Test(name, ""), text { text } {}
+        void setup(TerminalSize) override {}
+
+        void fill(Buffer& _sink) noexcept override { _sink.write(text); }
+
+      private:
+        std::string text;
+    };
+
+    /// Scrolls text within top/bottom margins (DECSTBM) covering a given percentage of the screen,
+    /// the way pagers and editors scroll a window below a fixed header.
+    class ScrollRegion: public Test
+    {
+      public:
+        explicit ScrollRegion(unsigned heightPercent) noexcept:
+            Test(std::format("scroll_region_{}", heightPercent), ""), _heightPercent { heightPercent }
+        {
+        }
+
+        void setup(TerminalSize size) noexcept override
+        {
+            _columns = std::max<unsigned>(size.columns, 2);
+            auto const lines = std::max<unsigned>(size.lines, 2);
+            auto const height = std::clamp(lines * _heightPercent / 100, 2u, lines);
+            _top = (lines - height) / 2 + 1;
+            _bottom = _top + height - 1;
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            writeCSI(_sink, { _top, _bottom }, "r");
+            moveCursor(_sink, 1, _bottom);
+            for (unsigned i = _top; i <= _bottom; ++i)
+            {
+                writeRandomText(_sink, _random, _columns - 1);
+                _sink.write("\r\n");
+            }
+        }
+
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033[r"); }
+
+      private:
+        Random _random { DefaultSeed };
+        unsigned _heightPercent;
+        unsigned _columns = 0;
+        unsigned _top = 1;
+        unsigned _bottom = 1;
+    };
+
+    /// Inserts (IL) and deletes (DL) lines at random rows.
+    class InsertDeleteLines: public Test
+    {
+      public:
+        InsertDeleteLines() noexcept: Test("insert_delete_lines", "") {}
+
+        void setup(TerminalSize size) noexcept override
+        {
+            _columns = std::max<unsigned>(size.columns, 2);
+            _lines = std::max<unsigned>(size.lines, 4);
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            moveCursor(_sink, 1, _random.between(1, _lines));
+            writeCSI(_sink, { _random.between(1, _lines / 4) }, "L");
+            writeRandomText(_sink, _random, _random.between(1, _columns - 1));
+
+            moveCursor(_sink, 1, _random.between(1, _lines));
+            writeCSI(_sink, { _random.between(1, _lines / 4) }, "M");
+            writeRandomText(_sink, _random, _random.between(1, _columns - 1));
+        }
+
+      private:
+        Random _random { DefaultSeed };
+        unsigned _columns = 0;
+        unsigned _lines = 0;
+    };
+
+    /// Scrolls the screen down by issuing reverse index (RI) at the top line.
+    class ReverseIndex: public Test
+    {
+      public:
+        ReverseIndex() noexcept: Test("reverse_index", "") {}
+
+        void setup(TerminalSize size) noexcept override
+        {
+            _columns = std::max<unsigned>(size.columns, 2);
+            _lines = std::max<unsigned>(size.lines, 1);
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            moveCursor(_sink, 1, 1);
+            for (unsigned i = 0; i < _lines; ++i)
+            {
+                _sink.write("\033M");
+                writeRandomText(_sink, _random, _columns - 1);
+                writeChar(_sink, '\r');
+            }
+        }
+
+      private:
+        Random _random { DefaultSeed };
+        unsigned _columns = 0;
+        unsigned _lines = 0;
+    };
+
+    /// Scrolls text within left/right margins (DECSLRM), like a vertically split tmux pane does.
+    class LeftRightMarginScroll: public Test
+    {
+      public:
+        LeftRightMarginScroll() noexcept: Test("left_right_margin_scroll", "") {}
+
+        void setup(TerminalSize size) noexcept override
+        {
+            auto const columns = std::max<unsigned>(size.columns, 4);
+            _lines = std::max<unsigned>(size.lines, 2);
+            _left = columns / 2 + 1;
+            _right = columns;
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            _sink.write("\033[?69h");
+            writeCSI(_sink, { _left, _right }, "s");
+            moveCursor(_sink, _left, _lines);
+            for (unsigned i = 0; i < _lines; ++i)
+            {
+                writeRandomText(_sink, _random, _right - _left);
+                _sink.write("\r\n");
+            }
+        }
+
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033[s\033[?69l"); }
+
+      private:
+        Random _random { DefaultSeed };
+        unsigned _lines = 0;
+        unsigned _left = 1;
+        unsigned _right = 1;
+    };
+
+    /// Screen coordinates of a rectangle, 1-based and inclusive.
+    struct Rectangle
+    {
+        unsigned top;
+        unsigned left;
+        unsigned bottom;
+        unsigned right;
+
+        unsigned cells() const noexcept { return (bottom - top + 1) * (right - left + 1); }
+    };
+
+    /// Base for tests that interleave text with erase or rectangular operations and count the cells affected.
+    class CellOperationTest: public Test
+    {
+      public:
+        using Test::Test;
+
+        void setup(TerminalSize size) noexcept override
+        {
+            _columns = std::max<unsigned>(size.columns, 2);
+            _lines = std::max<unsigned>(size.lines, 2);
+        }
+
+      protected:
+        void writeText(Buffer& _sink, unsigned x, unsigned y)
+        {
+            auto const count = _random.between(1, _columns - x + 1);
+            moveCursor(_sink, x, y);
+            writeRandomText(_sink, _random, count);
+            countUnits("cells", count);
+        }
+
+        Rectangle randomRectangle() noexcept
+        {
+            auto const top = _random.between(1, _lines);
+            auto const left = _random.between(1, _columns);
+            return { top, left, _random.between(top, _lines), _random.between(left, _columns) };
+        }
+
+        Random _random { DefaultSeed };
+        unsigned _columns = 0;
+        unsigned _lines = 0;
+    };
+
+    /// Writes text and erases parts of the line (EL 0, 1 and 2) after it.
+    class EraseInLine: public CellOperationTest
+    {
+      public:
+        EraseInLine() noexcept: CellOperationTest("erase_in_line", "") {}
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            auto const y = _random.between(1, _lines);
+            writeText(_sink, 1, y);
+
+            auto const x = _random.between(1, _columns);
+            moveCursor(_sink, x, y);
+            switch (_mode++ % 3)
+            {
+                case 0:
+                    _sink.write("\033[K");
+                    countUnits("cells", _columns - x + 1);
+                    break;
+                case 1:
+                    _sink.write("\033[1K");
+                    countUnits("cells", x);
+                    break;
+                default:
+                    _sink.write("\033[2K");
+                    countUnits("cells", _columns);
+                    break;
+            }
+        }
+
+      private:
+        unsigned _mode = 0;
+    };
+
+    /// Fills the screen with text and erases parts of it (ED 0, 1 and 2).
+    class EraseInDisplay: public CellOperationTest
+    {
+      public:
+        EraseInDisplay() noexcept: CellOperationTest("erase_in_display", "") {}
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            for (unsigned y = 1; y <= _lines; ++y)
+                writeText(_sink, 1, y);
+
+            auto const x = _random.between(1, _columns);
+            auto const y = _random.between(1, _lines);
+            moveCursor(_sink, x, y);
+            switch (_mode++ % 3)
+            {
+                case 0:
+                    _sink.write("\033[J");
+                    countUnits("cells", (_columns - x + 1) + (_lines - y) * _columns);
+                    break;
+                case 1:
+                    _sink.write("\033[1J");
+                    countUnits("cells", (y - 1) * _columns + x);
+                    break;
+                default:
+                    _sink.write("\033[2J");
+                    countUnits("cells", _columns * _lines);
+                    break;
+            }
+        }
+
+      private:
+        unsigned _mode = 0;
+    };
+
+    /// Copies random rectangular areas to random destinations (DECCRA).
+    class CopyRectangle: public CellOperationTest
+    {
+      public:
+        CopyRectangle() noexcept: CellOperationTest("copy_rectangle", "") {}
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            writeText(_sink, 1, _random.between(1, _lines));
+
+            auto const source = randomRectangle();
+            auto const top = _random.between(1, _lines - (source.bottom - source.top));
+            auto const left = _random.between(1, _columns - (source.right - source.left));
+            writeCSI(_sink, { source.top, source.left, source.bottom, source.right, 1, top, left, 1 }, "$v");
+            countUnits("cells", source.cells());
+        }
+    };
+
+    /// Fills random rectangular areas with a printable character (DECFRA).
+    class FillRectangle: public CellOperationTest
+    {
+      public:
+        FillRectangle() noexcept: CellOperationTest("fill_rectangle", "") {}
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            writeText(_sink, 1, _random.between(1, _lines));
+
+            auto const area = randomRectangle();
+            auto const ch = static_cast<unsigned char>(randomAsciiChar(_random));
+            writeCSI(_sink, { ch, area.top, area.left, area.bottom, area.right }, "$x");
+            countUnits("cells", area.cells());
+        }
+    };
+
+    /// Erases random rectangular areas (DECERA).
+    class EraseRectangle: public CellOperationTest
+    {
+      public:
+        EraseRectangle() noexcept: CellOperationTest("erase_rectangle", "") {}
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            writeText(_sink, 1, _random.between(1, _lines));
+
+            auto const area = randomRectangle();
+            writeCSI(_sink, { area.top, area.left, area.bottom, area.right }, "$z");
+            countUnits("cells", area.cells());
+        }
+    };
+
+    /// Streams a procedural image of a given palette size, covering a percentage of the screen, as Sixel.
+    class SixelImage: public Test
+    {
+      public:
+        SixelImage(ImagePattern pattern, unsigned colorCount, unsigned screenPercent) noexcept:
+            Test(std::format("sixel_{}_{}c_{}pct", patternName(pattern), colorCount, screenPercent), ""),
+            _pattern { pattern },
+            _colorCount { colorCount },
+            _screenPercent { screenPercent }
+        {
+        }
+
+        void setup(TerminalSize size) override
+        {
+            auto const width = std::max(size.columns * CellWidthPixels * _screenPercent / 100, 1u);
+            auto const height = std::max(size.lines * CellHeightPixels * _screenPercent / 100, 1u);
+            _pixels = size_t { width } * height;
+            _image = encodeSixel(createImage(_pattern, _colorCount, width, height, DefaultSeed));
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            moveCursor(_sink, 1, 1);
+            _sink.write(_image);
+            countUnits("images", 1);
+            countUnits("pixels", _pixels);
+        }
+
+        // The output is cut off at the test size, possibly within the sixel data.
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033\\"); }
+
+      private:
+        ImagePattern _pattern;
+        unsigned _colorCount;
+        unsigned _screenPercent;
+        size_t _pixels = 0;
+        std::string _image;
+    };
+
+    /// Transmits procedural images with the kitty graphics protocol.
+    class KittyImage: public Test
+    {
+      public:
+        KittyImage(KittyTransmission transmission, size_t chunkSize, bool alpha) noexcept:
+            Test(std::format(
+                     "kitty_{}_{}_{}", transmissionName(transmission), alpha ? "rgba" : "rgb", chunkSize),
+                 ""),
+            _transmission { transmission },
+            _chunkSize { chunkSize },
+            _alpha { alpha }
+        {
+        }
+
+        void setup(TerminalSize size) override
+        {
+            _columns = std::max<unsigned>(size.columns, 1);
+            _lines = std::max<unsigned>(size.lines, 1);
+            auto const width = std::max(size.columns * CellWidthPixels / 2, 1u);
+            auto const height = std::max(size.lines * CellHeightPixels / 2, 1u);
+            _image = createImage(ImagePattern::Photo, 256, width, height, DefaultSeed);
+            _frame = createImage(ImagePattern::Photo, 256, width, height, DefaultSeed + 1);
+            _pixels = rawPixels(_image, _alpha, 0, 0, width, height);
+            _control = std::format("f={},s={},v={},q=2", _alpha ? 32 : 24, width, height);
+            _transmitted = false;
+
+            _sequence.clear();
+            switch (_transmission)
+            {
+                case KittyTransmission::Direct:
+                    appendKittyCommand(_sequence, "a=T," + _control, _pixels, _chunkSize);
+                    break;
+                case KittyTransmission::PlacementReuse:
+                    appendKittyCommand(_sequence, "a=t,i=1," + _control, _pixels, _chunkSize);
+                    break;
+                case KittyTransmission::AnimationFrames:
+                    appendKittyCommand(_sequence, "a=T,i=2," + _control, _pixels, _chunkSize);
+                    break;
+            }
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            switch (_transmission)
+            {
+                case KittyTransmission::Direct:
+                    moveCursor(_sink, 1, 1);
+                    _sink.write(_sequence);
+                    countUnits("images", 1);
+                    countUnits("decoded bytes", _pixels.size());
+                    break;
+                case KittyTransmission::PlacementReuse: {
+                    if (!_transmitted)
+                    {
+                        _sink.write(_sequence);
+                        countUnits("decoded bytes", _pixels.size());
+                        _transmitted = true;
+                    }
+                    // Arguments are evaluated in unspecified order, so draw the position first.
+                    auto const column = _random.between(1, _columns);
+                    auto const line = _random.between(1, _lines);
+                    moveCursor(_sink, column, line);
+                    _sink.write("\033_Ga=p,i=1,p=1,q=2\033\\");
+                    countUnits("images", 1);
+                    break;
+                }
+                case KittyTransmission::AnimationFrames: {
+                    if (!_transmitted)
+                    {
+                        moveCursor(_sink, 1, 1);
+                        _sink.write(_sequence);
+                        countUnits("images", 1);
+                        countUnits("decoded bytes", _pixels.size());
+                        _transmitted = true;
+                    }
+                    // Replaces a random quarter of the root frame, as a video or progress animation would.
+                    auto const width = std::max(_frame.width / 2, 1u);
+                    auto const height = std::max(_frame.height / 2, 1u);
+                    auto const left = _random.between(0, _frame.width - width);
+                    auto const top = _random.between(0, _frame.height - height);
+                    auto const pixels = rawPixels(_frame, _alpha, left, top, width, height);
+                    auto const control = std::format("a=f,i=2,r=1,x={},y={},s={},v={},f={},q=2",
+                                                     left,
+                                                     top,
+                                                     width,
+                                                     height,
+                                                     _alpha ? 32 : 24);
+                    _frameSequence.clear();
+                    appendKittyCommand(_frameSequence, control, pixels, _chunkSize);
+                    _sink.write(_frameSequence);
+                    countUnits("images", 1);
+                    countUnits("decoded bytes", pixels.size());
+                    break;
+                }
+            }
+        }
+
+        // The output is cut off at the test size, possibly within an APC command, which ST terminates.
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033\\\033_Ga=d,d=A,q=2\033\\"); }
+
+      private:
+        static std::string_view transmissionName(KittyTransmission transmission) noexcept
+        {
+            switch (transmission)
+            {
+                case KittyTransmission::Direct: return "direct";
+                case KittyTransmission::PlacementReuse: return "placement";
+                case KittyTransmission::AnimationFrames: return "animation";
+            }
+            return "unknown";
+        }
+
+        KittyTransmission _transmission;
+        size_t _chunkSize;
+        bool _alpha;
+        Random _random { DefaultSeed };
+        unsigned _columns = 0;
+        unsigned _lines = 0;
+        bool _transmitted = false;
+        IndexedImage _image;
+        IndexedImage _frame;
+        std::string _pixels;
+        std::string _control;
+        std::string _sequence;
+        std::string _frameSequence;
+    };
+
+    /// Displays procedural PNG images inline with the iTerm2 OSC 1337 protocol.
+    class ITerm2Image: public Test
+    {
+      public:
+        explicit ITerm2Image(ImagePattern pattern) noexcept:
+            Test(std::format("iterm2_{}_png", patternName(pattern)), ""), _pattern { pattern }
+        {
+        }
+
+        void setup(TerminalSize size) override
+        {
+            auto const width = std::max(size.columns * CellWidthPixels / 2, 1u);
+            auto const height = std::max(size.lines * CellHeightPixels / 2, 1u);
+            auto const png = encodePng(createImage(_pattern, 256, width, height, DefaultSeed));
+            _decodedSize = png.size();
+            _sequence = std::format(
+                "\033]1337;File=inline=1;size={};width={}px;height={}px:", png.size(), width, height);
+            appendBase64(_sequence, png);
+            _sequence += '\a';
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            moveCursor(_sink, 1, 1);
+            _sink.write(_sequence);
+            countUnits("images", 1);
+            countUnits("decoded bytes", _decodedSize);
+        }
+
+        // The output is cut off at the test size, possibly within the OSC string.
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033\\"); }
+
+      private:
+        ImagePattern _pattern;
+        size_t _decodedSize = 0;
+        std::string _sequence;
+    };
+
+    /// Writes lines of graphemes drawn from a random vocabulary of mixed width graphemes.
+    /// The larger the vocabulary, the less a terminal's grapheme width and glyph caches can help.
+    class UnicodeCorpus: public Test
+    {
+      public:
+        UnicodeCorpus(size_t vocabularySize, uint64_t seed) noexcept:
+            Test(std::format("unicode_corpus_{}", vocabularySize), ""),
+            _vocabularySize { std::max<size_t>(vocabularySize, 1) },
+            _seed { seed }
+        {
+        }
+
+        void setup(TerminalSize size) override
+        {
+            auto random = Random { _seed };
+            std::vector<Grapheme> vocabulary;
+            std::unordered_set<std::string> known;
+            for (size_t attempts = 0; vocabulary.size() < _vocabularySize && attempts < 16 * _vocabularySize;
+                 ++attempts)
+            {
+                auto grapheme = randomGrapheme(random);
+                if (known.insert(grapheme.text).second)
+                    vocabulary.emplace_back(std::move(grapheme));
+            }
+
+            auto const columns = std::max<unsigned>(size.columns, 2);
+            auto const lastIndex = static_cast<unsigned>(vocabulary.size() - 1);
+            unsigned width = 0;
+            _text.clear();
+            _graphemeCount = 0;
+            while (_text.size() < 4 * 1024 * 1024)
+            {
+                auto const& grapheme = vocabulary[random.between(0, lastIndex)];
+                if (width + grapheme.width > columns)
+                {
+                    _text += '\n';
+                    width = 0;
+                }
+                _text += grapheme.text;
+                width += grapheme.width;
+                ++_graphemeCount;
+            }
+            _text += '\n';
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            _sink.write(_text);
+            countUnits("graphemes", _graphemeCount);
+        }
+
+      private:
+        size_t _vocabularySize;
+        uint64_t _seed;
+        size_t _graphemeCount = 0;
+        std::string _text;
+    };
+
+    /// Writes lines of colored words, as compilers, ls or bat do, using a single SGR encoding.
+    /// A given percentage of the words repeats the previous word's SGR, which is redundant for the terminal.
+    class SgrMatrix: public Test
+    {
+      public:
+        SgrMatrix(SgrEncoding encoding, unsigned redundantPercent) noexcept:
+            Test(std::format("sgr_{}_{}pct_redundant", encodingName(encoding), redundantPercent), ""),
+            _encoding { encoding },
+            _redundantPercent { redundantPercent }
+        {
+        }
+
+        void setup(TerminalSize size) override
+        {
+            auto random = Random { DefaultSeed };
+            auto const columns = std::max<unsigned>(size.columns, 2);
+            std::string sgr;
+            unsigned width = 0;
+            _text.clear();
+            _sgrCount = 0;
+            while (_text.size() < 4 * 1024 * 1024)
+            {
+                auto const wordLength = random.between(1, 12);
+                if (width + wordLength + 1 > columns)
+                {
+                    _text += "\033[m\n";
+                    ++_sgrCount;
+                    width = 0;
+                }
+                if (sgr.empty() || random.between(1, 100) > _redundantPercent)
+                    sgr = randomSgr(random);
+                _text += sgr;
+                ++_sgrCount;
+                for (auto i = 0u; i < wordLength; ++i)
+                    _text += randomAsciiChar(random);
+                _text += ' ';
+                width += wordLength + 1;
+            }
+            _text += "\033[m\n";
+        }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            _sink.write(_text);
+            countUnits("sgr", _sgrCount);
+        }
+
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033[m"); }
+
+      private:
+        static std::string_view encodingName(SgrEncoding encoding) noexcept
+        {
+            switch (encoding)
+            {
+                case SgrEncoding::Basic16: return "16color";
+                case SgrEncoding::Indexed256: return "256color";
+                case SgrEncoding::TrueColor: return "truecolor";
+                case SgrEncoding::TrueColorColon: return "truecolor_colon";
+                case SgrEncoding::Underline: return "underline";
+                case SgrEncoding::Attributes: return "attributes";
+            }
+            return "unknown";
+        }
+
+        std::string randomSgr(Random& random) const
+        {
+            // Values are drawn one by one, as the evaluation order of function arguments is unspecified.
+            auto const byte = [&]() {
+                return random.between(0, 255);
+            };
+            auto const rgb = [&](char separator) {
+                auto const r = byte();
+                auto const g = byte();
+                auto const b = byte();
+                return std::format("{}{}{}{}{}", r, separator, g, separator, b);
+            };
+
+            switch (_encoding)
+            {
+                case SgrEncoding::Basic16: {
+                    auto const fg = random.between(0, 1) ? random.between(30, 37) : random.between(90, 97);
+                    auto const bg = random.between(0, 1) ? random.between(40, 47) : random.between(100, 107);
+                    return std::format("\033[{};{}m", fg, bg);
+                }
+                case SgrEncoding::Indexed256: {
+                    auto const fg = byte();
+                    auto const bg = byte();
+                    return std::format("\033[38;5;{};48;5;{}m", fg, bg);
+                }
+                case SgrEncoding::TrueColor: {
+                    auto const fg = rgb(';');
+                    auto const bg = rgb(';');
+                    return std::format("\033[38;2;{};48;2;{}m", fg, bg);
+                }
+                case SgrEncoding::TrueColorColon: {
+                    auto const fg = rgb(':');
+                    auto const bg = rgb(':');
+                    return std::format("\033[38:2::{};48:2::{}m", fg, bg);
+                }
+                case SgrEncoding::Underline: {
+                    // curly, dotted, dashed etc. underline styles with an underline color
+                    auto const style = random.between(0, 5);
+                    if (random.between(0, 1))
+                        return std::format("\033[4:{};58:2::{}m", style, rgb(':'));
+                    return std::format("\033[4:{};58;5;{}m", style, byte());
+                }
+                case SgrEncoding::Attributes:
+                    switch (random.between(0, 5))
+                    {
+                        case 0: return "\033[1m";
+                        case 1: return "\033[22m";
+                        case 2: return "\033[3m";
+                        case 3: return "\033[23m";
+                        case 4: return "\033[1;3;4m";
+                        default: return "\033[0m";
+                    }
+            }
+            return "\033[m";
+        }
+
+        SgrEncoding _encoding;
+        unsigned _redundantPercent;
+        size_t _sgrCount = 0;
+        std::string _text;
+    };
+
+    /// Renders full-screen frames, as a TUI would, each wrapped into a synchronized update (mode 2026).
+    /// Only a given percentage of the cells change per frame and a given percentage of those carries an SGR.
+    class SynchronizedFrames: public Test
+    {
+      public:
+        SynchronizedFrames(unsigned changedPercent,
+                           unsigned sgrPercent,
+                           bool alternateScreen,
+                           unsigned framesPerRoundTrip) noexcept:
+            Test(std::format("sync_frames_{}pct_changed_{}pct_sgr{}",
+                             changedPercent,
+                             sgrPercent,
+                             alternateScreen ? "_altscreen" : ""),
+                 ""),
+            _changedPercent { changedPercent },
+            _sgrPercent { sgrPercent },
+            _alternateScreen { alternateScreen },
+            _framesPerRoundTrip { std::max(framesPerRoundTrip, 1u) }
+        {
+            averageTimeUnit = "frames";
+        }
+
+        void setup(TerminalSize size) noexcept override
+        {
+            _columns = std::max<unsigned>(size.columns, 1);
+            _lines = std::max<unsigned>(size.lines, 1);
+            _frameCount = 0;
+        }
+
+        void prepare(Buffer& _sink) override
+        {
+            if (_alternateScreen)
+                _sink.write("\033[?1049h");
+        }
 
         void fill(Buffer& _sink) noexcept override
         {
-            for (u16 y = 0; y < terminalSize.lines; ++y)
+            _sink.write("\033[?2026h");
+            for (unsigned y = 1; y <= _lines; ++y)
             {
-                moveCursor(_sink, 1, y + 1u);
-                for (u16 x = 0; x < terminalSize.columns; ++x)
+                auto previousChanged = false;
+                for (unsigned x = 1; x <= _columns; ++x)
                 {
-                    auto r = static_cast<uint8_t>(frameID);
-                    auto g = static_cast<uint8_t>(frameID + y);
-                    auto b = static_cast<uint8_t>(frameID + y + x);
-                    setTextColor(_sink, r, g, b);
+                    auto const changed = _random.between(1, 100) <= _changedPercent;
+                    if (changed)
+                    {
+                        if (!previousChanged)
+                            moveCursor(_sink, x, y);
+                        if (_random.between(1, 100) <= _sgrPercent)
+                            writeCSI(_sink, { 38, 5, _random.between(0, 255) }, "m");
+                        writeChar(_sink, randomAsciiChar(_random));
+                    }
+                    previousChanged = changed;
+                }
+            }
+            _sink.write("\033[m\033[?2026l");
 
-                    r = static_cast<uint8_t>(frameID + y + x);
-                    g = static_cast<uint8_t>(frameID + y);
-                    b = static_cast<uint8_t>(frameID);
-                    setBackgroundColor(_sink, r, g, b);
+            countUnits("frames", 1);
+            if (++_frameCount % _framesPerRoundTrip == 0)
+                requestRoundTrip(_sink);
+        }
 
-                    writeChar(_sink, static_cast<char>('a' + (frameID + x + y) % ('z' - 'a')));
-                }
+        void teardown(Buffer& _sink) noexcept override
+        {
+            if (_alternateScreen)
+                _sink.write("\033[?1049l");
+        }
+
+      private:
+        unsigned _changedPercent;
+        unsigned _sgrPercent;
+        bool _alternateScreen;
+        unsigned _framesPerRoundTrip;
+        Random _random { DefaultSeed };
+        unsigned _columns = 0;
+        unsigned _lines = 0;
+        unsigned _frameCount = 0;
+    };
+
+    /// Clears the scrollback and then streams lines in phases of a fixed number of lines,
+    /// so that the throughput per phase shows how it degrades as the scrollback fills up.
+    class ScrollbackGrowth: public Test
+    {
+      public:
+        ScrollbackGrowth(size_t phaseLines, size_t totalLines) noexcept:
+            Test(std::format("scrollback_growth_{}", totalLines), ""),
+            _phaseLines { std::max<size_t>(phaseLines, 1) },
+            _totalLines { std::max<size_t>(totalLines, 1) }
+        {
+        }
+
+        void setup(TerminalSize size) override
+        {
+            // All lines have the same length, so that phases can be measured in bytes.
+            auto const lineLength = std::max<unsigned>(size.columns, 2) - 1;
+            auto random = Random { DefaultSeed };
+            _lines.clear();
+            for (auto i = 0; i < 1024; ++i)
+            {
+                for (auto k = 0u; k < lineLength; ++k)
+                    _lines += randomAsciiChar(random);
+                _lines += '\n';
             }
+            auto const lineSize = size_t { lineLength } + 1;
+            totalSize = _totalLines * lineSize;
+            phaseSize = _phaseLines * lineSize;
+            _lineCount = 1024;
+        }
+
+        void prepare(Buffer& _sink) override { _sink.write("\033[H\033[2J\033[3J"); }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            _sink.write(_lines);
+            countUnits("lines", _lineCount);
         }
+
+      private:
+        size_t _phaseLines;
+        size_t _totalLines;
+        size_t _lineCount = 0;
+        std::string _lines;
     };
 
-    class Binary: public Test
+    /// Streams long wrapped lines and resizes the terminal (CSI 8 t) between the given sizes every few
+    /// bytes, as tiling window managers do when rearranging windows.
+    /// Every resize is preceded by a round trip that waits for the text, and followed by one that records
+    /// the latency of the resize alone.
+    class ResizeReflow: public Test
     {
       public:
-        Binary() noexcept: Test("binary", "") {}
+        ResizeReflow(std::vector<TerminalSize> sizes, size_t bytesPerResize) noexcept:
+            Test(std::format("resize_reflow_{}kb", bytesPerResize / 1024), ""),
+            _sizes { std::move(sizes) },
+            _bytesPerResize { std::max<size_t>(bytesPerResize, 1) }
+        {
+        }
 
-        void setup(TerminalSize) override
+        void setup(TerminalSize size) noexcept override
         {
-            text.resize(4 * 1024 * 1024);
-            for (auto i = text.data(), e = i + text.size(); i != e; ++i)
+            _initialSize = size;
+            _columns = std::max<unsigned>(size.columns, 1);
+            for (auto const& other: _sizes)
+                _columns = std::max<unsigned>(_columns, other.columns);
+        }
+
+        // Every fill cycles through all sizes, starting after and ending at the first one, which is the
+        // size the test starts at. This way the replayed buffer continues where it left off.
+        void fill(Buffer& _sink) noexcept override
+        {
+            if (_sizes.empty())
             {
-                char const value = randomAsciiChar();
-                if (value % 26 != 0)
-                    *i = value;
-                else
-                    *i = '\n';
+                writeText(_sink);
+                return;
+            }
+
+            auto previous = _sizes.front();
+            for (size_t i = 1; i <= _sizes.size(); ++i)
+            {
+                auto const& size = _sizes[i % _sizes.size()];
+                if (size == previous)
+                    continue;
+                writeText(_sink);
+                requestRoundTrip(_sink, { .recorded = false });
+                writeCSI(_sink, { 8, size.lines, size.columns }, "t");
+                countUnits("resizes", 1);
+                requestRoundTrip(_sink, { .terminalSize = size });
+                previous = size;
             }
         }
 
-        void fill(Buffer& _sink) noexcept override { _sink.write(text); }
+        void teardown(Buffer& _sink) noexcept override
+        {
+            if (!_sizes.empty())
+                writeCSI(_sink, { 8, _initialSize.lines, _initialSize.columns }, "t");
+        }
 
-        void teardown(Buffer& _sink) noexcept override { _sink.write("\033c"); }
+      private:
+        void writeText(Buffer& _sink) noexcept
+        {
+            auto const begin = _sink.size();
+            while (_sink.good() && _sink.size() - begin < _bytesPerResize)
+            {
+                writeRandomText(_sink, _random, _random.between(2 * _columns, 8 * _columns));
+                writeChar(_sink, '\n');
+            }
+        }
+
+        std::vector<TerminalSize> _sizes;
+        size_t _bytesPerResize;
+        Random _random { DefaultSeed };
+        TerminalSize _initialSize {};
+        unsigned _columns = 0;
+    };
+
+    /// Base of the OSC tests, which write OSC sequences in chunks and count them.
+    class OscTest: public Test
+    {
+      public:
+        using Test::Test;
+
+        void setup(TerminalSize size) noexcept override { _columns = std::max<unsigned>(size.columns, 16); }
+
+        void fill(Buffer& _sink) noexcept override
+        {
+            _chunk.clear();
+            size_t sequences = 0;
+            while (_chunk.size() < 64 * 1024)
+                sequences += writeSequences(_chunk);
+            _sink.write(_chunk);
+            countUnits("sequences", sequences);
+        }
+
+        // The output is cut off at the test size, possibly within an OSC string.
+        void teardown(Buffer& _sink) noexcept override { _sink.write("\033\\"); }
+
+      protected:
+        /// Appends a piece of output and returns the number of OSC sequences in it.
+        virtual size_t writeSequences(std::string& output) = 0;
+
+        void appendWord(std::string& output, unsigned length)
+        {
+            for (unsigned i = 0; i < length; ++i)
+                output += static_cast<char>('a' + _random.between(0, 25));
+        }
+
+        void appendWords(std::string& output, unsigned length)
+        {
+            auto const end = output.size() + length;
+            while (output.size() < end)
+            {
+                auto const remaining = static_cast<unsigned>(end - output.size());
+                appendWord(output, std::min(_random.between(2, 10), remaining));
+                if (output.size() + 1 < end)
+                    output += ' ';
+            }
+        }
+
+        Random _random { DefaultSeed };
+        unsigned _columns = 0;
 
       private:
-        std::string text;
+        std::string _chunk;
     };
 
-    class Line: public Test
+    /// Writes lines of words that are each a hyperlink (OSC 8), as ls --hyperlink or compilers do.
+    /// Every hyperlink has a URI of its own, or one of a few that are used over and over.
+    class Hyperlinks: public OscTest
     {
       public:
-        Line(std::string name, std::string text): Test(name, ""), text { text } {}
-        void setup(TerminalSize) override {}
+        explicit Hyperlinks(bool uniqueUris) noexcept:
+            OscTest(std::format("osc8_hyperlinks_{}", uniqueUris ? "unique" : "repeated"), ""),
+            _uniqueUris { uniqueUris }
+        {
+        }
 
-        void fill(Buffer& _sink) noexcept override { _sink.write(text); }
+        // Also closes a hyperlink that the cut off output may have left open.
+        void teardown(Buffer& _sink) noexcept override
+        {
+            OscTest::teardown(_sink);
+            _sink.write("\033]8;;\033\\");
+        }
+
+      protected:
+        size_t writeSequences(std::string& output) override
+        {
+            auto constexpr RepeatedUriCount = 16u;
+
+            size_t sequences = 0;
+            unsigned width = 0;
+            for (auto length = _random.between(3, 12); width + length < _columns;
+                 length = _random.between(3, 12))
+            {
+                auto const id = _uniqueUris ? _nextId++ : _random.between(0, RepeatedUriCount - 1);
+                output += "\033]8;;file://localhost/home/user/project/src/file";
+                appendNumber(output, id);
+                output += ".cpp\033\\";
+                appendWord(output, length);
+                output += "\033]8;;\033\\ ";
+                width += length + 1;
+                sequences += 2;
+            }
+            output += '\n';
+            return sequences;
+        }
 
       private:
-        std::string text;
+        bool _uniqueUris;
+        unsigned _nextId = 0;
+    };
+
+    /// Sets the window title (OSC 2), or icon name and window title (OSC 0), over and over.
+    /// The title is saved before and restored after the test.
+    class WindowTitles: public OscTest
+    {
+      public:
+        explicit WindowTitles(unsigned ps) noexcept:
+            OscTest(std::format("osc{}_title_flood", ps), ""), _ps { ps }
+        {
+        }
+
+        void prepare(Buffer& _sink) override { _sink.write("\033[22;0t"); }
+        void teardown(Buffer& _sink) noexcept override
+        {
+            OscTest::teardown(_sink);
+            _sink.write("\033[23;0t");
+        }
+
+      protected:
+        size_t writeSequences(std::string& output) override
+        {
+            output += "\033]";
+            appendNumber(output, _ps);
+            output += ';';
+            appendWords(output, _random.between(16, 64));
+            output += "\033\\";
+            return 1;
+        }
+
+      private:
+        unsigned _ps;
+    };
+
+    /// Sets the clipboard (OSC 52) to the given amount of random data, as editors do over SSH.
+    /// The clipboard is cleared after the test.
+    class Clipboard: public OscTest
+    {
+      public:
+        explicit Clipboard(size_t payloadSize) noexcept:
+            OscTest(std::format("osc52_clipboard_{}kb", payloadSize / 1024), ""),
+            _payloadSize { std::max<size_t>(payloadSize, 1) }
+        {
+        }
+
+        void teardown(Buffer& _sink) noexcept override
+        {
+            OscTest::teardown(_sink);
+            _sink.write("\033]52;c;\033\\");
+        }
+
+      protected:
+        size_t writeSequences(std::string& output) override
+        {
+            _payload.resize(_payloadSize);
+            for (auto& byte: _payload)
+                byte = static_cast<char>(_random.next() >> 56);
+
+            output += "\033]52;c;";
+            appendBase64(output, _payload);
+            output += "\033\\";
+            return 1;
+        }
+
+      private:
+        size_t _payloadSize;
+        std::string _payload;
+    };
+
+    /// Sends desktop notifications, either with OSC 9 (message only) or OSC 777 (title and body).
+    class Notifications: public OscTest
+    {
+      public:
+        explicit Notifications(unsigned ps) noexcept:
+            OscTest(std::format("osc{}_notifications", ps), ""), _ps { ps }
+        {
+        }
+
+      protected:
+        size_t writeSequences(std::string& output) override
+        {
+            if (_ps == 777)
+            {
+                output += "\033]777;notify;";
+                appendWords(output, _random.between(8, 24));
+                output += ';';
+            }
+            else
+            {
+                output += "\033]";
+                appendNumber(output, _ps);
+                output += ';';
+            }
+            appendWords(output, _random.between(16, 96));
+            output += "\033\\";
+            return 1;
+        }
+
+      private:
+        unsigned _ps;
     };
 } // namespace
 
@@ -512,6 +2964,150 @@ std::unique_ptr<Test> unicode_flag(size_t line_length)
     return std::make_unique<Line>(name, text);
 }
 
+std::unique_ptr<Test> sgr_matrix(SgrEncoding encoding, unsigned redundantPercent)
+{
+    return std::make_unique<SgrMatrix>(encoding, redundantPercent);
+}
+
+std::unique_ptr<Test> unicode_arabic(size_t line_length)
+{
+    auto name = std::to_string(line_length) + " unicode arabic";
+    return std::make_unique<Line>(name, wordLines(ArabicWords, line_length, true, true));
+}
+
+std::unique_ptr<Test> unicode_hebrew(size_t line_length)
+{
+    auto name = std::to_string(line_length) + " unicode hebrew";
+    return std::make_unique<Line>(name, wordLines(HebrewWords, line_length, true, true));
+}
+
+std::unique_ptr<Test> unicode_devanagari(size_t line_length)
+{
+    auto name = std::to_string(line_length) + " unicode devanagari";
+    return std::make_unique<Line>(name, wordLines(DevanagariWords, line_length, true, false));
+}
+
+std::unique_ptr<Test> unicode_bengali(size_t line_length)
+{
+    auto name = std::to_string(line_length) + " unicode bengali";
+    return std::make_unique<Line>(name, wordLines(BengaliWords, line_length, true, false));
+}
+
+std::unique_ptr<Test> unicode_thai(size_t line_length)
+{
+    auto name = std::to_string(line_length) + " unicode thai";
+    return std::make_unique<Line>(name, wordLines(ThaiWords, line_length, false, false));
+}
+
+std::unique_ptr<Test> unicode_corpus(size_t vocabularySize, uint64_t seed)
+{
+    return std::make_unique<UnicodeCorpus>(vocabularySize, seed);
+}
+
+std::unique_ptr<Test> scroll_region(unsigned heightPercent)
+{
+    return std::make_unique<ScrollRegion>(heightPercent);
+}
+
+std::unique_ptr<Test> insert_delete_lines()
+{
+    return std::make_unique<InsertDeleteLines>();
+}
+
+std::unique_ptr<Test> reverse_index()
+{
+    return std::make_unique<ReverseIndex>();
+}
+
+std::unique_ptr<Test> left_right_margin_scroll()
+{
+    return std::make_unique<LeftRightMarginScroll>();
+}
+
+std::unique_ptr<Test> erase_in_line()
+{
+    return std::make_unique<EraseInLine>();
+}
+
+std::unique_ptr<Test> erase_in_display()
+{
+    return std::make_unique<EraseInDisplay>();
+}
+
+std::unique_ptr<Test> copy_rectangle()
+{
+    return std::make_unique<CopyRectangle>();
+}
+
+std::unique_ptr<Test> fill_rectangle()
+{
+    return std::make_unique<FillRectangle>();
+}
+
+std::unique_ptr<Test> erase_rectangle()
+{
+    return std::make_unique<EraseRectangle>();
+}
+
+std::unique_ptr<Test> sixel_image(ImagePattern pattern, unsigned colorCount, unsigned screenPercent)
+{
+    return std::make_unique<SixelImage>(pattern, colorCount, screenPercent);
+}
+
+std::unique_ptr<Test> kitty_image(KittyTransmission transmission, size_t chunkSize, bool alpha)
+{
+    return std::make_unique<KittyImage>(transmission, chunkSize, alpha);
+}
+
+std::unique_ptr<Test> iterm2_image(ImagePattern pattern)
+{
+    return std::make_unique<ITerm2Image>(pattern);
+}
+
+std::unique_ptr<Test> synchronized_frames(unsigned changedPercent,
+                                          unsigned sgrPercent,
+                                          bool alternateScreen,
+                                          unsigned framesPerRoundTrip)
+{
+    return std::make_unique<SynchronizedFrames>(
+        changedPercent, sgrPercent, alternateScreen, framesPerRoundTrip);
+}
+
+std::unique_ptr<Test> scrollback_growth(size_t phaseLines, size_t totalLines)
+{
+    return std::make_unique<ScrollbackGrowth>(phaseLines, totalLines);
+}
+
+std::unique_ptr<Test> resize_reflow(std::vector<TerminalSize> sizes, size_t bytesPerResize)
+{
+    return std::make_unique<ResizeReflow>(std::move(sizes), bytesPerResize);
+}
+
+std::unique_ptr<Test> hyperlinks(bool uniqueUris)
+{
+    return std::make_unique<Hyperlinks>(uniqueUris);
+}
+
+std::unique_ptr<Test> window_titles(unsigned ps)
+{
+    return std::make_unique<WindowTitles>(ps);
+}
+
+std::unique_ptr<Test> clipboard(size_t payloadSize)
+{
+    return std::make_unique<Clipboard>(payloadSize);
+}
+
+std::unique_ptr<Test> notifications(unsigned ps)
+{
+    return std::make_unique<Notifications>(ps);
+}
+
+std::unique_ptr<Test> synthesized(std::string name, WorkloadModel model, uint64_t seed)
+{
+    return std::make_unique<Synthesized>(std::move(name), std::move(model), seed);
+}
+
 std::unique_ptr<Test> crafted(std::string name, std::string description, std::string text)
 {
     return std::make_unique<CraftedTest>(std::move(name), std::move(description), std::move(text));
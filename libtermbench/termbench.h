@@ -13,11 +13,15 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <functional>
 #include <iosfwd>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -44,20 +48,78 @@ struct Buffer
     bool write(std::string_view chunk) noexcept
     {
         if (_data.size() > _maxSize)
+        {
+            _dropped = true;
             return false;
+        }
         _data.append(chunk.data(), chunk.size());
         return true;
     }
 
     std::string_view output() const noexcept { return std::string_view { _data.data(), _data.size() }; }
 
-    void clear() noexcept { _data.clear(); }
+    /// Tells whether a write was dropped because the buffer was full.
+    bool dropped() const noexcept { return _dropped; }
+
+    /// Discards everything written after the first size bytes.
+    void truncate(size_t size) noexcept
+    {
+        _data.resize(std::min(size, _data.size()));
+        _dropped = false;
+    }
+
+    void clear() noexcept { truncate(0); }
     bool empty() const noexcept { return _data.empty(); }
     size_t size() const noexcept { return _data.size(); }
 
   private:
     std::string _data;
     std::size_t _maxSize;
+    bool _dropped = false;
+};
+
+/// Procedural image patterns used by the image tests.
+enum class ImagePattern
+{
+    Gradient,
+    Noise,
+    Photo, // smooth areas with soft edges, similar to natural images
+};
+
+/// How the kitty graphics tests transmit their images.
+enum class KittyTransmission
+{
+    Direct,          // transmit and display every image (a=T)
+    PlacementReuse,  // transmit once, then only place the stored image (a=p)
+    AnimationFrames, // transmit once, then replace parts of the root frame (a=f)
+};
+
+/// SGR encodings used by the SGR matrix tests.
+enum class SgrEncoding
+{
+    Basic16,        // SGR 30-37, 90-97 and their background counterparts
+    Indexed256,     // SGR 38;5;n and 48;5;n
+    TrueColor,      // SGR 38;2;r;g;b and 48;2;r;g;b
+    TrueColorColon, // SGR 38:2::r:g:b and 48:2::r:g:b
+    Underline,      // underline styles (4:n) with underline colors (58)
+    Attributes,     // bold and italic toggles, and resets (SGR 0)
+};
+
+/// Counts a test specific unit of work (such as affected cells or images).
+struct WorkUnits
+{
+    std::string name;
+    size_t count = 0;
+};
+
+/// A point in a test's output after which the benchmark waits for the terminal to answer a DA1 request.
+struct RoundTripRequest
+{
+    size_t offset = 0;
+    /// Whether the time is recorded, or the round trip only makes sure the terminal has caught up.
+    bool recorded = true;
+    /// If set, the round trip also waits for the terminal to report this size, as after a resize.
+    std::optional<TerminalSize> terminalSize = std::nullopt;
 };
 
 /// Describes a single test.
@@ -66,6 +128,22 @@ struct Test
     std::string name;
     std::string description;
 
+    /// Units of work produced by fill() in addition to the plain bytes, reset before every run.
+    std::vector<WorkUnits> units {};
+
+    /// Name of the unit whose average time per unit is reported (such as "frames"), if any.
+    std::string averageTimeUnit {};
+
+    /// Round trips at offsets into the filled buffer, if the benchmark supports round trips.
+    /// Reset before every run.
+    std::vector<RoundTripRequest> roundTripRequests {};
+
+    /// Number of bytes to write, or 0 to use the benchmark's test size.
+    size_t totalSize = 0;
+
+    /// If not 0, the time is also recorded for every phase of this many bytes written.
+    size_t phaseSize = 0;
+
     virtual ~Test() = default;
 
     Test(std::string _name, std::string _description) noexcept: name { _name }, description { _description }
@@ -73,8 +151,42 @@ struct Test
     }
 
     virtual void setup(TerminalSize /*terminalSize*/) {}
+    /// Writes output that must be written only once before the measured output, such as clearing the screen.
+    virtual void prepare(Buffer& /*stdoutBuffer*/) {}
     virtual void fill(Buffer& /*stdoutBuffer*/) noexcept = 0;
     virtual void teardown(Buffer& /*stdoutBuffer*/) {}
+
+    void countUnits(std::string_view unitName, size_t n)
+    {
+        for (auto& unit: units)
+        {
+            if (unit.name == unitName)
+            {
+                unit.count += n;
+                return;
+            }
+        }
+        units.emplace_back(std::string(unitName), n);
+    }
+
+    /// Requests a round trip after everything written to the buffer so far.
+    void requestRoundTrip(Buffer const& buffer, RoundTripRequest request = {})
+    {
+        request.offset = buffer.size();
+        roundTripRequests.push_back(request);
+    }
+};
+
+/// Time taken for a phase of a test's output.
+struct Phase
+{
+    size_t bytesWritten;
+    std::chrono::microseconds time;
+
+    double megabytesPerSecond() const noexcept
+    {
+        return double(bytesWritten) / 1024.0 / 1024.0 / (double(time.count()) / 1'000'000.0);
+    }
 };
 
 struct Result
@@ -82,33 +194,83 @@ struct Result
     std::reference_wrapper<Test> test;
     std::chrono::milliseconds time;
     size_t bytesWritten;
+    std::vector<WorkUnits> unitsWritten {};
+    std::vector<std::chrono::microseconds> roundTrips {};
+    std::vector<Phase> phases {};
+
+    /// Time the same output took with a null writer, if calibration is enabled.
+    std::optional<std::chrono::microseconds> harnessTime {};
+
+    /// Description of the system state (such as load and CPU frequency) when the test started.
+    std::map<std::string, std::string> environment {};
+
+    /// Returns the given count per second of this result's time.
+    double perSecond(double count) const noexcept { return count / (double(time.count()) / 1000.0); }
+
+    /// Returns the bytes per second of this result's time without the harness time, or 0 if not calibrated.
+    double terminalBytesPerSecond() const noexcept
+    {
+        if (!harnessTime)
+            return 0.0;
+        auto const terminalTime = std::chrono::duration<double>(time - *harnessTime).count();
+        return terminalTime > 0 ? double(bytesWritten) / terminalTime : 0.0;
+    }
 };
 
 class Benchmark
 {
   public:
+    /// @param _roundTrip  optional function that sends a DA1 request and waits for the terminal's reply,
+    ///                    used by tests that request round trips. It returns false if no reply arrived,
+    ///                    after which the benchmark stops requesting round trips.
     Benchmark(std::function<void(char const*, size_t n)> _writer,
               size_t _testSizeMB,
               TerminalSize terminalSize,
-              std::function<void(Test const&)> _beforeTest = {});
+              std::function<void(Test const&)> _beforeTest = {},
+              std::function<bool()> _roundTrip = {});
 
     void add(std::unique_ptr<Test> _test);
 
+    /// Writes every test's output with the given writer (such as one into the null device) before measuring
+    /// it, to measure the harness' own cost.
+    void enableCalibration(std::function<void(char const*, size_t)> writer)
+    {
+        calibrationWriter_ = std::move(writer);
+    }
+
+    /// Sets a function returning the current terminal size, which confirms the resizes of round trips
+    /// that request a terminal size. Without it, such round trips are not recorded.
+    void setTerminalSizeProbe(std::function<TerminalSize()> probe) { terminalSizeProbe_ = std::move(probe); }
+
+    /// Sets a function describing the system state, which is recorded into the results before every test.
+    void setEnvironmentProbe(std::function<std::map<std::string, std::string>()> probe)
+    {
+        environmentProbe_ = std::move(probe);
+    }
+
     void runAll();
 
     void summarize(std::ostream& os);
     void summarizeToJson(std::ostream& os);
 
     std::vector<Result> const& results() const noexcept { return results_; }
+    TerminalSize terminalSize() const noexcept { return terminalSize_; }
 
     constexpr size_t totalSizeBytes() const noexcept { return testSizeMB_ * 1024 * 1024; }
 
   private:
-    void writeOutput(Buffer const& testBuffer);
+    /// Writes the test's output and returns the time spent waiting for round trips that were not answered.
+    std::chrono::steady_clock::duration writeOutput(Buffer const& testBuffer,
+                                                    Test const& test,
+                                                    Result& result);
     void updateWindowTitle(std::string_view _title);
 
     std::function<void(char const*, size_t)> writer_;
     std::function<void(Test const&)> beforeTest_;
+    std::function<bool()> roundTrip_;
+    std::function<TerminalSize()> terminalSizeProbe_;
+    std::function<std::map<std::string, std::string>()> environmentProbe_;
+    std::function<void(char const*, size_t)> calibrationWriter_;
     size_t testSizeMB_;
     TerminalSize terminalSize_;
     std::chrono::steady_clock::time_point lastWindowTitleUpdate_;
@@ -117,6 +279,58 @@ class Benchmark
     std::vector<Result> results_;
 };
 
+/// Prints the results of benchmarks that ran the same tests at different terminal sizes
+/// as a matrix of test x terminal size, with raw and normalized throughput.
+void summarizeSweep(std::ostream& os, std::vector<Benchmark> const& benchmarks);
+void summarizeSweepToJson(std::ostream& os, std::vector<Benchmark> const& benchmarks);
+
+/// Statistical model of captured terminal output, used to synthesize arbitrarily long output
+/// with the same mix of text, control characters and escape sequences as the capture.
+///
+/// The capture is split into tokens: escape sequences and control characters are kept verbatim,
+/// text runs only by their (rounded) length. An order-N Markov chain over these tokens decides what
+/// comes next, and an order-1 Markov chain over the characters of all text runs fills in the text.
+struct WorkloadModel
+{
+    /// Verbatim bytes, or a text run of about textLength bytes.
+    struct Token
+    {
+        std::string bytes {};
+        size_t textLength = 0;
+    };
+
+    struct Successor
+    {
+        uint32_t token;           // token or character index
+        uint64_t cumulativeCount; // number of observations of this and all preceding successors
+        uint32_t state;           // index of the state that follows
+    };
+
+    /// The last tokens (or characters) seen, and what followed them.
+    struct State
+    {
+        std::vector<uint32_t> context {};
+        std::vector<Successor> successors {};
+    };
+
+    unsigned order = 2;
+    std::vector<Token> tokens {};
+    std::vector<State> states {};
+    std::vector<std::string> characters {};
+    std::vector<State> characterStates {};
+
+    bool empty() const noexcept { return states.empty(); }
+};
+
+/// Builds a model of the given capture, where @p order is the number of tokens that decide the next one.
+WorkloadModel trainWorkloadModel(std::string_view capture, unsigned order = 2);
+
+/// Serializes the model into a compact binary format, that loadWorkloadModel() reads back.
+std::string saveWorkloadModel(WorkloadModel const& model);
+std::optional<WorkloadModel> loadWorkloadModel(std::string_view data);
+/// Tells whether the data claims to be a saved model, even if it cannot be loaded.
+bool isWorkloadModel(std::string_view data) noexcept;
+
 inline std::string sizeStr(double _value)
 {
     if ((long double) (_value) >= (1024ull * 1024ull * 1024ull)) // GB
@@ -148,7 +362,45 @@ struct meta<termbench::Result>
         [](T const& result) {
             double bytesPerSecond = double(result.bytesWritten) / (double(result.time.count()) / 1000.0);
             return bytesPerSecond / 1024.0 / 1024.0;
-        });
+        },
+        "units/s",
+        [](T const& result) {
+            std::map<std::string, double> unitsPerSecond;
+            for (auto const& unit: result.unitsWritten)
+                unitsPerSecond[unit.name] = result.perSecond(double(unit.count));
+            return unitsPerSecond;
+        },
+        "units",
+        [](T const& result) {
+            std::map<std::string, size_t> units;
+            for (auto const& unit: result.unitsWritten)
+                units[unit.name] = unit.count;
+            return units;
+        },
+        "round trips (us)",
+        [](T const& result) {
+            std::vector<int64_t> latencies;
+            for (auto const latency: result.roundTrips)
+                latencies.push_back(latency.count());
+            return latencies;
+        },
+        "phases MB/s",
+        [](T const& result) {
+            std::vector<double> throughput;
+            for (auto const& phase: result.phases)
+                throughput.push_back(phase.megabytesPerSecond());
+            return throughput;
+        },
+        "harness time (us)",
+        [](T const& result) -> std::optional<int64_t> {
+            if (!result.harnessTime)
+                return std::nullopt;
+            return result.harnessTime->count();
+        },
+        "terminal MB/s",
+        [](T const& result) { return result.terminalBytesPerSecond() / 1024.0 / 1024.0; },
+        "environment",
+        &T::environment);
 };
 } // namespace glz
 
@@ -163,11 +415,41 @@ std::unique_ptr<Test> binary();
 std::unique_ptr<Test> ascii_line(size_t);
 std::unique_ptr<Test> sgr_line(size_t);
 std::unique_ptr<Test> sgrbg_line(size_t);
+std::unique_ptr<Test> sgr_matrix(SgrEncoding encoding, unsigned redundantPercent);
 std::unique_ptr<Test> unicode_simple(size_t);
 std::unique_ptr<Test> unicode_two_codepoints(size_t);
 std::unique_ptr<Test> unicode_three_codepoints(size_t);
 std::unique_ptr<Test> unicode_flag(size_t);
 std::unique_ptr<Test> unicode_fire_as_text(size_t); // U+FEOE
 std::unique_ptr<Test> unicode_fire(size_t);
+std::unique_ptr<Test> unicode_arabic(size_t);     // mixed with left-to-right runs
+std::unique_ptr<Test> unicode_hebrew(size_t);     // mixed with left-to-right runs
+std::unique_ptr<Test> unicode_devanagari(size_t); // with conjuncts
+std::unique_ptr<Test> unicode_bengali(size_t);    // with conjuncts
+std::unique_ptr<Test> unicode_thai(size_t);       // without spaces
+std::unique_ptr<Test> unicode_corpus(size_t vocabularySize, uint64_t seed);
+std::unique_ptr<Test> scroll_region(unsigned heightPercent);
+std::unique_ptr<Test> insert_delete_lines();
+std::unique_ptr<Test> reverse_index();
+std::unique_ptr<Test> left_right_margin_scroll();
+std::unique_ptr<Test> erase_in_line();
+std::unique_ptr<Test> erase_in_display();
+std::unique_ptr<Test> copy_rectangle();
+std::unique_ptr<Test> fill_rectangle();
+std::unique_ptr<Test> erase_rectangle();
+std::unique_ptr<Test> sixel_image(ImagePattern pattern, unsigned colorCount, unsigned screenPercent);
+std::unique_ptr<Test> kitty_image(KittyTransmission transmission, size_t chunkSize, bool alpha);
+std::unique_ptr<Test> iterm2_image(ImagePattern pattern);
+std::unique_ptr<Test> synchronized_frames(unsigned changedPercent,
+                                          unsigned sgrPercent,
+                                          bool alternateScreen,
+                                          unsigned framesPerRoundTrip);
+std::unique_ptr<Test> scrollback_growth(size_t phaseLines, size_t totalLines);
+std::unique_ptr<Test> resize_reflow(std::vector<TerminalSize> sizes, size_t bytesPerResize);
+std::unique_ptr<Test> hyperlinks(bool uniqueUris);   // OSC 8
+std::unique_ptr<Test> window_titles(unsigned ps);    // OSC 0 or 2
+std::unique_ptr<Test> clipboard(size_t payloadSize); // OSC 52
+std::unique_ptr<Test> notifications(unsigned ps);    // OSC 9 or 777
+std::unique_ptr<Test> synthesized(std::string name, WorkloadModel model, uint64_t seed);
 std::unique_ptr<Test> crafted(std::string name, std::string description, std::string text);
 } // namespace termbench::tests
@@ -37,6 +37,16 @@ function get_values(data, data_type)
         name = "unicode fire as text"
     elseif data_type == :flag
         name = "unicode flag"
+    elseif data_type == :arabic
+        name = "unicode arabic"
+    elseif data_type == :hebrew
+        name = "unicode hebrew"
+    elseif data_type == :devanagari
+        name = "unicode devanagari"
+    elseif data_type == :bengali
+        name = "unicode bengali"
+    elseif data_type == :thai
+        name = "unicode thai"
     end
 
     lines = Vector{Float64}()
@@ -116,5 +126,13 @@ generate_for_terminal_l("xterm_results")
 generate_for_terminal_l("kitty_results")
 generate_for_terminal_l("wezterm_results")
 
-types =   [:ascii :sgr :sgr_bg :unicode :fire :fire_text :flag :diacritic :diacritic_double]
+types = [:arabic :hebrew :devanagari :bengali :thai]
+generate_for_terminal_l = (n) -> generate_for_terminal(n, "results_complex_script_")
+generate_for_terminal_l("contour_results")
+generate_for_terminal_l("alacritty_results")
+generate_for_terminal_l("xterm_results")
+generate_for_terminal_l("kitty_results")
+generate_for_terminal_l("wezterm_results")
+
+types =   [:ascii :sgr :sgr_bg :unicode :fire :fire_text :flag :diacritic :diacritic_double :arabic :hebrew :devanagari :bengali :thai]
 [ save("comparison_"*string(type)*".png", generate_comparison(type)) for type in types ]
@@ -0,0 +1,387 @@
+/**
+ * This file is part of the "termbench" project
+ *   Copyright (c) 2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures libtermbench's own hot paths: every test's fill(), Buffer::write and the writers,
+// so that a slower harness does not go unnoticed behind the terminal numbers.
+
+#include <libtermbench/termbench.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using std::cerr;
+using std::cout;
+
+using namespace std::chrono;
+using namespace std::string_view_literals;
+
+using termbench::Result;
+using termbench::Test;
+using termbench::TerminalSize;
+
+namespace
+{
+
+auto constexpr ScreenSize = TerminalSize { 80, 24 };
+auto constexpr MinimumTime = milliseconds { 200 };
+
+struct SelfBenchSettings
+{
+    size_t testSizeMB = 64;
+    unsigned repeat = 3;
+    std::string fileout {};
+    std::optional<int> earlyExitCode = std::nullopt;
+};
+
+SelfBenchSettings parseArguments(int argc, char const* argv[])
+{
+    auto settings = SelfBenchSettings {};
+    for (int i = 1; i < argc; ++i)
+    {
+        if (argv[i] == "--size"sv && i + 1 < argc)
+        {
+            ++i;
+            settings.testSizeMB = std::max<size_t>(std::stoul(argv[i]), 1);
+        }
+        else if (argv[i] == "--repeat"sv && i + 1 < argc)
+        {
+            ++i;
+            settings.repeat = std::max(static_cast<unsigned>(std::stoul(argv[i])), 1u);
+        }
+        else if (argv[i] == "--output"sv && i + 1 < argc)
+        {
+            ++i;
+            settings.fileout = argv[i];
+        }
+        else if (argv[i] == "--help"sv || argv[i] == "-h"sv)
+        {
+            cout << std::format("{} [--size MB] [--repeat N] [--output FILE] [--help]\n", argv[0]);
+            return { .earlyExitCode = EXIT_SUCCESS };
+        }
+        else
+        {
+            cerr << std::format("Invalid argument usage.\n");
+            return { .earlyExitCode = EXIT_FAILURE };
+        }
+    }
+    return settings;
+}
+
+/// Writes lines of numbers of all magnitudes, the way the tests write the parameters of their sequences.
+class WriteNumbers: public Test
+{
+  public:
+    WriteNumbers() noexcept: Test("write_number", "") {}
+
+    void fill(termbench::Buffer& _sink) noexcept override
+    {
+        char number[16];
+        for (unsigned i = 0; i < 1024; ++i)
+        {
+            auto const end = std::to_chars(number, number + sizeof(number) - 1, _value >> (_value % 32)).ptr;
+            *end = i % 16 == 15 ? '\n' : ' ';
+            _sink.write({ number, static_cast<size_t>(end + 1 - number) });
+            _value = _value * 1664525u + 1013904223u;
+        }
+        countUnits("numbers", 1024);
+    }
+
+  private:
+    unsigned _value = 1;
+};
+
+/// Writes lines of random characters from the MMIX generator, the way the tests write their text.
+class RandomAsciiChars: public Test
+{
+  public:
+    RandomAsciiChars() noexcept: Test("random_ascii_char", "") {}
+
+    void fill(termbench::Buffer& _sink) noexcept override
+    {
+        char line[80];
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            for (auto& ch: std::span(line).first(79))
+            {
+                _state = _state * 6364136223846793005 + 1442695040888963407;
+                ch = static_cast<char>('a' + _state % 26);
+            }
+            line[79] = '\n';
+            _sink.write({ line, sizeof(line) });
+        }
+        countUnits("chars", 64 * 79);
+    }
+
+  private:
+    uint64_t _state = 1442695040888963407;
+};
+
+/// Returns one of each test generator, with typical parameters.
+std::vector<std::unique_ptr<Test>> createGenerators()
+{
+    using namespace termbench;
+
+    auto generators = std::vector<std::unique_ptr<Test>> {};
+    generators.emplace_back(std::make_unique<WriteNumbers>());
+    generators.emplace_back(std::make_unique<RandomAsciiChars>());
+    for (auto const chunkSize: { 16u, 256u, 4096u })
+        generators.emplace_back(tests::crafted(
+            std::format("buffer_write_{}", chunkSize), "", std::string(chunkSize - 1, 'a') + '\n'));
+
+    generators.emplace_back(tests::many_lines());
+    generators.emplace_back(tests::long_lines());
+    generators.emplace_back(tests::sgr_fg_lines());
+    generators.emplace_back(tests::sgr_fgbg_lines());
+    generators.emplace_back(tests::binary());
+    generators.emplace_back(tests::ascii_line(ScreenSize.columns));
+    generators.emplace_back(tests::sgr_line(ScreenSize.columns));
+    generators.emplace_back(tests::sgrbg_line(ScreenSize.columns));
+    for (auto const encoding: { SgrEncoding::Basic16,
+                                SgrEncoding::Indexed256,
+                                SgrEncoding::TrueColor,
+                                SgrEncoding::TrueColorColon,
+                                SgrEncoding::Underline,
+                                SgrEncoding::Attributes })
+        generators.emplace_back(tests::sgr_matrix(encoding, 50));
+    generators.emplace_back(tests::unicode_simple(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_two_codepoints(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_three_codepoints(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_flag(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_fire_as_text(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_fire(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_arabic(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_hebrew(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_devanagari(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_bengali(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_thai(ScreenSize.columns));
+    generators.emplace_back(tests::unicode_corpus(256, 1));
+    generators.emplace_back(tests::scroll_region(50));
+    generators.emplace_back(tests::insert_delete_lines());
+    generators.emplace_back(tests::reverse_index());
+    generators.emplace_back(tests::left_right_margin_scroll());
+    generators.emplace_back(tests::erase_in_line());
+    generators.emplace_back(tests::erase_in_display());
+    generators.emplace_back(tests::copy_rectangle());
+    generators.emplace_back(tests::fill_rectangle());
+    generators.emplace_back(tests::erase_rectangle());
+    generators.emplace_back(tests::sixel_image(ImagePattern::Photo, 256, 25));
+    generators.emplace_back(tests::kitty_image(KittyTransmission::Direct, 4096, true));
+    generators.emplace_back(tests::kitty_image(KittyTransmission::PlacementReuse, 4096, true));
+    generators.emplace_back(tests::kitty_image(KittyTransmission::AnimationFrames, 4096, true));
+    generators.emplace_back(tests::iterm2_image(ImagePattern::Photo));
+    generators.emplace_back(tests::synchronized_frames(100, 50, false, 10));
+    generators.emplace_back(tests::scrollback_growth(100'000, 1'000'000));
+    generators.emplace_back(tests::resize_reflow({ ScreenSize, { 60, 24 } }, 256 * 1024));
+    for (auto const uniqueUris: { false, true })
+        generators.emplace_back(tests::hyperlinks(uniqueUris));
+    generators.emplace_back(tests::window_titles(2));
+    generators.emplace_back(tests::clipboard(64 * 1024));
+    for (auto const ps: { 9u, 777u })
+        generators.emplace_back(tests::notifications(ps));
+
+    // The synthesizer is modeled on the output of another generator.
+    auto capture = Buffer { 1 };
+    auto source = tests::sgr_matrix(SgrEncoding::TrueColor, 50);
+    source->setup(ScreenSize);
+    while (capture.good())
+        source->fill(capture);
+    generators.emplace_back(
+        tests::synthesized("synthesized", trainWorkloadModel(capture.output()), 1));
+
+    return generators;
+}
+
+/// Measures how fast the test fills a buffer of the given size, which is what Benchmark::runAll() does
+/// before writing anything. The buffer is filled as often as needed to measure the time in milliseconds,
+/// and the fastest of the repeated runs is kept.
+Result measureFill(Test& test, termbench::Buffer& buffer, unsigned repeat)
+{
+    std::optional<Result> fastest;
+    test.setup(ScreenSize);
+    for (unsigned i = 0; i < repeat; ++i)
+    {
+        test.units.clear();
+        auto time = steady_clock::duration {};
+        size_t bytesWritten = 0;
+        while (time < MinimumTime)
+        {
+            buffer.clear();
+            test.roundTripRequests.clear();
+            auto const beginTime = steady_clock::now();
+            while (buffer.good())
+                test.fill(buffer);
+            time += steady_clock::now() - beginTime;
+            bytesWritten += buffer.size();
+        }
+
+        auto result = Result { .test = test,
+                               .time = duration_cast<milliseconds>(time),
+                               .bytesWritten = bytesWritten,
+                               .unitsWritten = test.units };
+        auto const bps = result.perSecond(double(bytesWritten));
+        if (!fastest || bps > fastest->perSecond(double(fastest->bytesWritten)))
+            fastest = std::move(result);
+    }
+    buffer.clear();
+    return *fastest;
+}
+
+#if !defined(_WIN32)
+/// Writes in pages like tb's stdout writer, but to the given file descriptor.
+void chunkedWrite(int fd, char const* _data, size_t _size)
+{
+    auto constexpr PageSize = size_t { 4096 };
+
+    while (_size > 0)
+    {
+        auto const n = write(fd, _data, std::min(_size, PageSize));
+        if (n < 0)
+        {
+            perror("write");
+            return;
+        }
+        _data += n;
+        _size -= static_cast<size_t>(n);
+    }
+}
+#endif
+
+/// Measures Benchmark::writeOutput() with the given writer, using plain text lines. The amount of output
+/// is doubled until the time can be measured in milliseconds, up to 1024 times the test size, and the fastest
+/// of the repeated runs is kept.
+Result measureWriter(std::string const& name,
+                     std::function<void(char const*, size_t)> const& writer,
+                     size_t testSizeMB,
+                     unsigned repeat,
+                     std::vector<termbench::Benchmark>& benchmarks)
+{
+    auto text = std::string {};
+    for (auto i = 0; i < 1024; ++i)
+        text += std::string(ScreenSize.columns - 1u, 'a') + '\n';
+
+    std::optional<Result> fastest;
+    for (unsigned i = 0; i < repeat; ++i)
+    {
+        auto const testSize = testSizeMB * 1024 * 1024;
+        for (auto totalSize = testSize;; totalSize *= 2)
+        {
+            // The results refer to the benchmark's tests, so the benchmark has to outlive them.
+            auto& tb = benchmarks.emplace_back(writer, testSizeMB, ScreenSize);
+            auto test = termbench::tests::crafted(name, "", text);
+            test->totalSize = totalSize;
+            tb.add(std::move(test));
+            tb.runAll();
+
+            auto result = tb.results().front();
+            if (result.time < MinimumTime && totalSize < 1024 * testSize)
+                continue;
+            // A writer that is too fast to measure even then (like the null writer) is reported
+            // at one millisecond, a lower bound of its throughput.
+            result.time = std::max(result.time, milliseconds { 1 });
+            if (!fastest || result.time < fastest->time)
+                fastest = result;
+            break;
+        }
+    }
+    return *fastest;
+}
+
+} // namespace
+
+int main(int argc, char const* argv[])
+{
+    auto const settings = parseArguments(argc, argv);
+    if (settings.earlyExitCode)
+        return settings.earlyExitCode.value();
+
+    auto results = std::vector<Result> {};
+
+    auto const generators = createGenerators();
+    auto buffer = termbench::Buffer { settings.testSizeMB };
+    for (auto const& generator: generators)
+    {
+        cerr << std::format("Measuring {}\n", generator->name);
+        results.emplace_back(measureFill(*generator, buffer, settings.repeat));
+    }
+
+    auto benchmarks = std::vector<termbench::Benchmark> {};
+    using Writer = std::function<void(char const*, size_t)>;
+    auto const measure = [&](std::string const& name, Writer const& writer) {
+        cerr << std::format("Measuring {}\n", name);
+        results.emplace_back(measureWriter(name, writer, settings.testSizeMB, settings.repeat, benchmarks));
+    };
+
+    measure("writer_null", [](char const*, size_t) {});
+
+#if !defined(_WIN32)
+    if (auto const devNull = open("/dev/null", O_WRONLY); devNull >= 0)
+    {
+        measure("writer_dev_null",
+                [devNull](char const* data, size_t size) { chunkedWrite(devNull, data, size); });
+        close(devNull);
+    }
+
+    if (int fds[2]; pipe(fds) == 0)
+    {
+        // Drain the pipe like a fast terminal would.
+        auto reader = std::thread([fd = fds[0]]() {
+            char chunk[65536];
+            while (read(fd, chunk, sizeof(chunk)) > 0)
+                ;
+        });
+        measure("writer_pipe",
+                [fd = fds[1]](char const* data, size_t size) { chunkedWrite(fd, data, size); });
+        close(fds[1]);
+        reader.join();
+        close(fds[0]);
+    }
+#endif
+
+    for (auto const& result: results)
+    {
+        auto const bps = result.perSecond(double(result.bytesWritten));
+        cout << std::format("{:>40}: {}/s\n", result.test.get().name, termbench::sizeStr(bps));
+        for (auto const& unit: result.unitsWritten)
+            cout << std::format("{:>40}  {:.0f} {}/s\n", "", result.perSecond(double(unit.count)), unit.name);
+    }
+
+    if (!settings.fileout.empty())
+    {
+        cout << "Writing summary into " << settings.fileout << std::endl;
+        std::ofstream writerToFile;
+        writerToFile.open(settings.fileout);
+        writerToFile << glz::write_json(results).value_or("error");
+    }
+
+    return EXIT_SUCCESS;
+}
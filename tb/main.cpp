@@ -14,6 +14,7 @@
 
 #include <libtermbench/termbench.h>
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <filesystem>
@@ -21,7 +22,13 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using std::cerr;
 using std::cout;
@@ -31,8 +38,13 @@ using namespace std::placeholders;
 
 #if !defined(_WIN32)
     #include <sys/ioctl.h>
+    #include <sys/resource.h>
     #include <sys/stat.h>
 
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sched.h>
+    #include <termios.h>
     #include <unistd.h>
 #else
     #include <Windows.h>
@@ -75,15 +87,20 @@ void nullWrite(char const*, size_t)
 {
 }
 
-template <const std::size_t StdoutFileNo>
-void chunkedWriteToStdout(char const* _data, size_t _size)
+#if !defined(_WIN32)
+using FileHandle = int;
+#else
+using FileHandle = HANDLE;
+#endif
+
+void chunkedWrite(FileHandle file, char const* _data, size_t _size)
 {
     auto constexpr PageSize = 4096; // 8192;
 
 #if !defined(_WIN32)
     while (_size >= PageSize)
     {
-        auto const n = write(StdoutFileNo, _data, PageSize);
+        auto const n = write(file, _data, PageSize);
         if (n < 0)
             perror("write");
         else
@@ -94,21 +111,106 @@ void chunkedWriteToStdout(char const* _data, size_t _size)
     }
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Wunused-result"
-    write(StdoutFileNo, _data, _size);
+    write(file, _data, _size);
     #pragma GCC diagnostic pop
 #else
-    HANDLE stdoutHandle = GetStdHandle(STD_OUTPUT_HANDLE);
     DWORD nwritten {};
     while (_size >= PageSize)
     {
-        WriteFile(stdoutHandle, _data, static_cast<DWORD>(_size), &nwritten, nullptr);
+        WriteFile(file, _data, static_cast<DWORD>(_size), &nwritten, nullptr);
         _data += nwritten;
         _size -= static_cast<size_t>(nwritten);
     }
-    WriteFile(stdoutHandle, _data, static_cast<DWORD>(_size), &nwritten, nullptr);
+    WriteFile(file, _data, static_cast<DWORD>(_size), &nwritten, nullptr);
 #endif
 }
 
+template <const std::size_t StdoutFileNo>
+void chunkedWriteToStdout(char const* _data, size_t _size)
+{
+#if !defined(_WIN32)
+    chunkedWrite(StdoutFileNo, _data, _size);
+#else
+    chunkedWrite(GetStdHandle(STD_OUTPUT_HANDLE), _data, _size);
+#endif
+}
+
+/// Opens the null device for writing, to measure the harness' own cost with the real writer.
+std::optional<FileHandle> openNullDevice()
+{
+#if !defined(_WIN32)
+    auto const file = open("/dev/null", O_WRONLY);
+    if (file < 0)
+        return std::nullopt;
+#else
+    auto const file = CreateFileA("NUL", GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return std::nullopt;
+#endif
+    return file;
+}
+
+#if !defined(_WIN32)
+/// Disables canonical input and echo for its lifetime, so that replies to requests can be read from stdin.
+class ScopedRawInput
+{
+  public:
+    ScopedRawInput() noexcept
+    {
+        if (tcgetattr(STDIN_FILENO, &_saved) < 0)
+            return;
+        auto raw = _saved;
+        raw.c_lflag &= ~tcflag_t(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        _active = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+
+    ~ScopedRawInput()
+    {
+        if (_active)
+            tcsetattr(STDIN_FILENO, TCSANOW, &_saved);
+    }
+
+    ScopedRawInput(ScopedRawInput const&) = delete;
+    ScopedRawInput& operator=(ScopedRawInput const&) = delete;
+
+    bool active() const noexcept { return _active; }
+
+  private:
+    termios _saved {};
+    bool _active = false;
+};
+
+/// Reads stdin until the reply to a DA1 request (CSI ? ... c) has been received or nothing arrives in time.
+bool waitForPrimaryDeviceAttributes() noexcept
+{
+    auto constexpr TimeoutMs = 5000;
+
+    auto pfd = pollfd { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
+    auto reply = std::string {};
+    while (poll(&pfd, 1, TimeoutMs) > 0)
+    {
+        char ch {};
+        if (read(STDIN_FILENO, &ch, 1) != 1)
+            return false;
+        reply += ch;
+        if (ch == 'c' && reply.find("\033[?") != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+/// Sends a DA1 request and waits for the reply, returning false if none arrived in time.
+bool requestPrimaryDeviceAttributes(void (*writer)(char const*, size_t)) noexcept
+{
+    // Discard stale input, such as a late reply to an earlier request.
+    tcflush(STDIN_FILENO, TCIFLUSH);
+    writer("\033[c", 3);
+    return waitForPrimaryDeviceAttributes();
+}
+#endif
+
 struct TestsToRun
 {
     bool manyLines { true };
@@ -117,20 +219,103 @@ struct TestsToRun
     bool sgrFgBgLines { true };
     bool binary { true };
     bool columnByColumn { false };
+    bool scrolling { false };
+    bool erase { false };
+    bool sixel { false };
+    bool inlineImages { false };
+    bool unicodeCorpus { false };
+    bool sgrMatrix { false };
+    bool synchronizedFrames { false };
+    size_t scrollbackGrowthLines { 0 };
+    bool resizeReflow { false };
+    bool osc { false };
 };
 
 struct BenchSettings
 {
     TerminalSize requestedTerminalSize {};
+    std::vector<TerminalSize> sizeSweep {};
     size_t testSizeMB = 32;
+    uint64_t seed = 1;
+    std::optional<unsigned> stableCpu = std::nullopt;
+    bool highPriority = false;
+    bool allowNoisy = false;
+    bool calibrate = false;
     bool nullSink = false;
     bool stdoutFastPath = false;
     std::vector<std::filesystem::path> craftedTests {};
+    std::vector<std::filesystem::path> synthesizedTests {};
     std::string fileout {};
     std::optional<int> earlyExitCode = std::nullopt;
     TestsToRun tests {};
 };
 
+std::string loadFileContents(std::filesystem::path const& path)
+{
+    std::ifstream file { path, std::ios::binary };
+    if (!file)
+        return {};
+
+    std::string content;
+    std::size_t const fileSize = std::filesystem::file_size(path);
+    content.resize(fileSize);
+    file.read(content.data(), static_cast<std::streamsize>(fileSize));
+    return content;
+}
+
+using WorkloadModels = std::vector<std::pair<std::string, termbench::WorkloadModel>>;
+
+/// Trains a workload model on the given capture and saves it for use with --synthesize.
+int trainModel(std::filesystem::path const& capturePath, std::filesystem::path const& modelPath)
+{
+    auto const capture = loadFileContents(capturePath);
+    if (capture.empty())
+    {
+        cerr << std::format("Failed to load file '{}'.\n", capturePath.string());
+        return EXIT_FAILURE;
+    }
+
+    auto const model = termbench::trainWorkloadModel(capture);
+    auto const data = termbench::saveWorkloadModel(model);
+    std::ofstream file { modelPath, std::ios::binary };
+    if (!file.write(data.data(), static_cast<std::streamsize>(data.size())))
+    {
+        cerr << std::format("Failed to write file '{}'.\n", modelPath.string());
+        return EXIT_FAILURE;
+    }
+
+    cout << std::format("Trained a model of {} tokens and {} states on {} into {} ({}).\n",
+                        model.tokens.size(),
+                        model.states.size(),
+                        termbench::sizeStr(static_cast<double>(capture.size())),
+                        modelPath.string(),
+                        termbench::sizeStr(static_cast<double>(data.size())));
+    return EXIT_SUCCESS;
+}
+
+/// Parses a comma separated list of terminal sizes, such as "80x24,120x40,400x120".
+std::optional<std::vector<TerminalSize>> parseTerminalSizes(std::string_view text)
+{
+    auto sizes = std::vector<TerminalSize> {};
+    while (!text.empty())
+    {
+        auto const comma = text.find(',');
+        auto const geometry = std::string(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view {} : text.substr(comma + 1);
+
+        unsigned columns = 0;
+        unsigned lines = 0;
+        char separator = 0;
+        if (std::sscanf(geometry.c_str(), "%u%c%u", &columns, &separator, &lines) != 3 || separator != 'x'
+            || columns == 0 || lines == 0 || columns > 0xFFFF || lines > 0xFFFF)
+            return std::nullopt;
+        sizes.push_back({ static_cast<unsigned short>(columns), static_cast<unsigned short>(lines) });
+    }
+    if (sizes.empty())
+        return std::nullopt;
+    return sizes;
+}
+
 BenchSettings parseArguments(int argc, char const* argv[], TerminalSize const& initialTerminalSize)
 {
     auto settings = BenchSettings { .requestedTerminalSize = initialTerminalSize };
@@ -165,6 +350,92 @@ BenchSettings parseArguments(int argc, char const* argv[], TerminalSize const& i
             settings.tests.sgrFgBgLines = false;
             settings.tests.binary = false;
         }
+        else if (argv[i] == "--scrolling"sv)
+        {
+            cout << std::format("Enabling scrolling tests.\n");
+            settings.tests.scrolling = true;
+        }
+        else if (argv[i] == "--erase"sv)
+        {
+            cout << std::format("Enabling erase and rectangular operation tests.\n");
+            settings.tests.erase = true;
+        }
+        else if (argv[i] == "--sixel"sv)
+        {
+            cout << std::format("Enabling Sixel image tests.\n");
+            settings.tests.sixel = true;
+        }
+        else if (argv[i] == "--inline-images"sv)
+        {
+            cout << std::format("Enabling kitty and iTerm2 inline image tests.\n");
+            settings.tests.inlineImages = true;
+        }
+        else if (argv[i] == "--unicode-corpus"sv)
+        {
+            cout << std::format("Enabling mixed-width unicode corpus tests.\n");
+            settings.tests.unicodeCorpus = true;
+        }
+        else if (argv[i] == "--sgr-matrix"sv)
+        {
+            cout << std::format("Enabling SGR matrix tests.\n");
+            settings.tests.sgrMatrix = true;
+        }
+        else if (argv[i] == "--sync-frames"sv)
+        {
+            cout << std::format("Enabling synchronized output frame tests.\n");
+            settings.tests.synchronizedFrames = true;
+        }
+        else if (argv[i] == "--scrollback-growth"sv && i + 1 < argc)
+        {
+            ++i;
+            settings.tests.scrollbackGrowthLines = static_cast<size_t>(std::stoul(argv[i]));
+            cout << std::format("Enabling scrollback growth test up to {} lines.\n",
+                                settings.tests.scrollbackGrowthLines);
+        }
+        else if (argv[i] == "--resize-reflow"sv)
+        {
+            cout << std::format("Enabling resize reflow test.\n");
+            settings.tests.resizeReflow = true;
+        }
+        else if (argv[i] == "--osc"sv)
+        {
+            cout << std::format("Enabling OSC tests, which may raise desktop notifications.\n");
+            settings.tests.osc = true;
+        }
+        else if (argv[i] == "--size-sweep"sv && i + 1 < argc)
+        {
+            ++i;
+            auto sizes = parseTerminalSizes(argv[i]);
+            if (!sizes)
+            {
+                cerr << std::format("Invalid terminal sizes '{}', expected e.g. 80x24,120x40.\n", argv[i]);
+                return { .earlyExitCode = EXIT_FAILURE };
+            }
+            settings.sizeSweep = std::move(*sizes);
+        }
+        else if (argv[i] == "--stable"sv && i + 1 < argc)
+        {
+            ++i;
+            settings.stableCpu = static_cast<unsigned>(std::stoul(argv[i]));
+            settings.calibrate = true;
+        }
+        else if (argv[i] == "--high-priority"sv)
+        {
+            settings.highPriority = true;
+        }
+        else if (argv[i] == "--allow-noisy"sv)
+        {
+            settings.allowNoisy = true;
+        }
+        else if (argv[i] == "--calibrate"sv)
+        {
+            settings.calibrate = true;
+        }
+        else if (argv[i] == "--seed"sv && i + 1 < argc)
+        {
+            ++i;
+            settings.seed = std::stoull(argv[i]);
+        }
         else if (argv[i] == "--size"sv && i + 1 < argc)
         {
             ++i;
@@ -173,10 +444,34 @@ BenchSettings parseArguments(int argc, char const* argv[], TerminalSize const& i
         else if (argv[i] == "--help"sv || argv[i] == "-h"sv)
         {
             cout << std::format("{} [--null-sink] [--fixed-size] [--stdout-fastpath] [--column-by-column] "
-                                "[--size MB] [--from-file FILE] [--output FILE] [--help]\n",
+                                "[--scrolling] [--erase] [--sixel] [--inline-images] [--unicode-corpus] "
+                                "[--sgr-matrix] [--sync-frames] [--scrollback-growth LINES] "
+                                "[--resize-reflow] [--osc] [--size-sweep COLSxLINES,...] [--stable CPU] "
+                                "[--high-priority] [--allow-noisy] [--calibrate] [--seed N] [--size MB] "
+                                "[--from-file FILE] [--synthesize MODEL|FILE] [--train-model FILE MODEL] "
+                                "[--output FILE] [--help]\n",
                                 argv[0]);
             return { .earlyExitCode = EXIT_SUCCESS };
         }
+        else if (argv[i] == "--train-model"sv && i + 2 < argc)
+        {
+            if (argc != 4)
+            {
+                cerr << std::format("--train-model does not take any other options.\n");
+                return { .earlyExitCode = EXIT_FAILURE };
+            }
+            return { .earlyExitCode = trainModel(argv[i + 1], argv[i + 2]) };
+        }
+        else if (argv[i] == "--synthesize"sv && i + 1 < argc)
+        {
+            ++i;
+            if (!std::filesystem::exists(argv[i]))
+            {
+                cerr << std::format("Failed to open file '{}'.\n", argv[i]);
+                return { .earlyExitCode = EXIT_FAILURE };
+            }
+            settings.synthesizedTests.emplace_back(argv[i]);
+        }
         else if (argv[i] == "--output"sv && i + 1 < argc)
         {
             ++i;
@@ -198,23 +493,44 @@ BenchSettings parseArguments(int argc, char const* argv[], TerminalSize const& i
             return { .earlyExitCode = EXIT_FAILURE };
         }
     }
+    if ((settings.highPriority || settings.allowNoisy) && !settings.stableCpu)
+    {
+        cerr << std::format("--high-priority and --allow-noisy require --stable.\n");
+        return { .earlyExitCode = EXIT_FAILURE };
+    }
     return settings;
 }
 
-std::string loadFileContents(std::filesystem::path const& path)
+/// Loads the workload models of the synthesized tests, named after their files.
+/// Saved models and raw captures are both accepted, the latter are modeled on the fly.
+std::optional<WorkloadModels> loadWorkloadModels(std::vector<std::filesystem::path> const& paths)
 {
-    std::ifstream file { path };
-    if (!file)
-        return {};
-
-    std::string content;
-    std::size_t const fileSize = std::filesystem::file_size(path);
-    content.resize(fileSize);
-    file.read(content.data(), static_cast<std::streamsize>(fileSize));
-    return content;
+    auto models = WorkloadModels {};
+    for (auto const& path: paths)
+    {
+        auto const content = loadFileContents(path);
+        auto model = termbench::loadWorkloadModel(content);
+        if (!model && termbench::isWorkloadModel(content))
+        {
+            cerr << std::format("Failed to load the workload model '{}', it is corrupt or truncated.\n",
+                                path.string());
+            return std::nullopt;
+        }
+        if (!model)
+            model = termbench::trainWorkloadModel(content);
+        if (model->empty())
+        {
+            cerr << std::format("Failed to load a workload model from '{}'.\n", path.string());
+            return std::nullopt;
+        }
+        models.emplace_back(std::format("synthesized_{}", path.filename().string()), std::move(*model));
+    }
+    return models;
 }
 
-bool addTestsToBenchmark(termbench::Benchmark& tb, BenchSettings const& settings)
+bool addTestsToBenchmark(termbench::Benchmark& tb,
+                         BenchSettings const& settings,
+                         WorkloadModels const& workloadModels)
 {
 
     if (settings.tests.manyLines)
@@ -228,6 +544,102 @@ bool addTestsToBenchmark(termbench::Benchmark& tb, BenchSettings const& settings
     if (settings.tests.binary)
         tb.add(termbench::tests::binary());
 
+    if (settings.tests.scrolling)
+    {
+        for (auto const heightPercent: { 10u, 50u, 90u })
+            tb.add(termbench::tests::scroll_region(heightPercent));
+        tb.add(termbench::tests::insert_delete_lines());
+        tb.add(termbench::tests::reverse_index());
+        tb.add(termbench::tests::left_right_margin_scroll());
+    }
+
+    if (settings.tests.erase)
+    {
+        tb.add(termbench::tests::erase_in_line());
+        tb.add(termbench::tests::erase_in_display());
+        tb.add(termbench::tests::copy_rectangle());
+        tb.add(termbench::tests::fill_rectangle());
+        tb.add(termbench::tests::erase_rectangle());
+    }
+
+    if (settings.tests.sixel)
+    {
+        using termbench::ImagePattern;
+        for (auto const pattern: { ImagePattern::Gradient, ImagePattern::Noise, ImagePattern::Photo })
+            for (auto const colorCount: { 16u, 256u })
+                for (auto const screenPercent: { 25u, 100u })
+                    tb.add(termbench::tests::sixel_image(pattern, colorCount, screenPercent));
+    }
+
+    if (settings.tests.inlineImages)
+    {
+        using termbench::KittyTransmission;
+        for (auto const chunkSize: { 512u, 4096u })
+            for (auto const alpha: { false, true })
+                tb.add(termbench::tests::kitty_image(KittyTransmission::Direct, chunkSize, alpha));
+        tb.add(termbench::tests::kitty_image(KittyTransmission::PlacementReuse, 4096, true));
+        tb.add(termbench::tests::kitty_image(KittyTransmission::AnimationFrames, 4096, true));
+        tb.add(termbench::tests::iterm2_image(termbench::ImagePattern::Photo));
+        tb.add(termbench::tests::iterm2_image(termbench::ImagePattern::Noise));
+    }
+
+    if (settings.tests.sgrMatrix)
+    {
+        using termbench::SgrEncoding;
+        for (auto const encoding: { SgrEncoding::Basic16,
+                                    SgrEncoding::Indexed256,
+                                    SgrEncoding::TrueColor,
+                                    SgrEncoding::TrueColorColon,
+                                    SgrEncoding::Underline,
+                                    SgrEncoding::Attributes })
+            for (auto const redundantPercent: { 0u, 50u, 90u })
+                tb.add(termbench::tests::sgr_matrix(encoding, redundantPercent));
+    }
+
+    if (settings.tests.synchronizedFrames)
+    {
+        auto constexpr FramesPerRoundTrip = 10u;
+        for (auto const changedPercent: { 10u, 100u })
+            for (auto const sgrPercent: { 0u, 50u })
+                tb.add(termbench::tests::synchronized_frames(
+                    changedPercent, sgrPercent, false, FramesPerRoundTrip));
+        tb.add(termbench::tests::synchronized_frames(100, 50, true, FramesPerRoundTrip));
+    }
+
+    if (settings.tests.scrollbackGrowthLines != 0)
+    {
+        auto constexpr PhaseLines = size_t { 100'000 };
+        tb.add(termbench::tests::scrollback_growth(PhaseLines, settings.tests.scrollbackGrowthLines));
+    }
+
+    if (settings.tests.resizeReflow)
+    {
+        // Alternates between the full size, two thirds of its width and half of its height.
+        auto const size = settings.requestedTerminalSize;
+        auto const sizes = std::vector<TerminalSize> {
+            size,
+            { static_cast<unsigned short>(std::max(size.columns * 2 / 3, 10)), size.lines },
+            { size.columns, static_cast<unsigned short>(std::max(size.lines / 2, 5)) },
+        };
+        tb.add(termbench::tests::resize_reflow(sizes, 256 * 1024));
+    }
+
+    if (settings.tests.osc)
+    {
+        for (auto const uniqueUris: { false, true })
+            tb.add(termbench::tests::hyperlinks(uniqueUris));
+        for (auto const ps: { 0u, 2u })
+            tb.add(termbench::tests::window_titles(ps));
+        for (auto const payloadSize: { 64u * 1024, 1024u * 1024 })
+            tb.add(termbench::tests::clipboard(payloadSize));
+        for (auto const ps: { 9u, 777u })
+            tb.add(termbench::tests::notifications(ps));
+    }
+
+    if (settings.tests.unicodeCorpus)
+        for (auto const vocabularySize: { 16u, 256u, 4096u, 65536u })
+            tb.add(termbench::tests::unicode_corpus(vocabularySize, settings.seed));
+
     for (auto const& test: settings.craftedTests)
     {
         auto content = loadFileContents(test);
@@ -239,6 +651,9 @@ bool addTestsToBenchmark(termbench::Benchmark& tb, BenchSettings const& settings
         tb.add(termbench::tests::crafted(test.filename().string(), "", std::move(content)));
     }
 
+    for (auto const& [name, model]: workloadModels)
+        tb.add(termbench::tests::synthesized(name, model, settings.seed));
+
     if (settings.tests.columnByColumn)
     {
         auto const maxColumns { settings.requestedTerminalSize.columns * 2u };
@@ -255,37 +670,166 @@ bool addTestsToBenchmark(termbench::Benchmark& tb, BenchSettings const& settings
         add_test(termbench::tests::unicode_fire_as_text);
         add_test(termbench::tests::unicode_fire);
         add_test(termbench::tests::unicode_flag);
+        add_test(termbench::tests::unicode_arabic);
+        add_test(termbench::tests::unicode_hebrew);
+        add_test(termbench::tests::unicode_devanagari);
+        add_test(termbench::tests::unicode_bengali);
+        add_test(termbench::tests::unicode_thai);
         add_test(termbench::tests::sgr_line);
         add_test(termbench::tests::sgrbg_line);
     }
     return true;
 }
 
+/// Pins tb to the given CPU, so that the scheduler does not move it between cores.
+bool pinToCpu(unsigned cpu)
+{
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#elif defined(_WIN32)
+    if (cpu >= sizeof(DWORD_PTR) * 8)
+        return false;
+    return SetProcessAffinityMask(GetCurrentProcess(), DWORD_PTR { 1 } << cpu) != 0;
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+bool raisePriority()
+{
+#if !defined(_WIN32)
+    return setpriority(PRIO_PROCESS, 0, -10) == 0;
+#else
+    return SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS) != 0;
+#endif
+}
+
+#if defined(__linux__)
+std::string readFirstLine(std::filesystem::path const& path)
+{
+    std::ifstream file { path };
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+#endif
+
+/// Describes the parts of the system state that affect the stability of the results.
+std::map<std::string, std::string> probeEnvironment(unsigned cpu)
+{
+    auto environment = std::map<std::string, std::string> { { "cpu", std::to_string(cpu) } };
+
+#if !defined(_WIN32)
+    double load[3] {};
+    if (getloadavg(load, 3) == 3)
+        environment["load average"] = std::format("{:.2f} {:.2f} {:.2f}", load[0], load[1], load[2]);
+#endif
+
+#if defined(__linux__)
+    auto const cpufreq = std::filesystem::path(std::format("/sys/devices/system/cpu/cpu{}/cpufreq", cpu));
+    if (auto governor = readFirstLine(cpufreq / "scaling_governor"); !governor.empty())
+        environment["cpu governor"] = std::move(governor);
+    if (auto frequency = readFirstLine(cpufreq / "scaling_cur_freq"); !frequency.empty())
+        environment["cpu frequency (kHz)"] = std::move(frequency);
+#endif
+
+    return environment;
+}
+
+/// Pins tb to the requested CPU and raises its priority if requested, and checks whether the system
+/// is quiet enough for stable results. Returns false if tb should not run.
+bool prepareStableRun(BenchSettings const& settings)
+{
+    auto constexpr NoisyLoadPerCpu = 0.5;
+
+    auto const cpu = settings.stableCpu.value_or(0);
+    if (!pinToCpu(cpu))
+        cerr << std::format("Warning: failed to pin tb to CPU {}.\n", cpu);
+    if (settings.highPriority && !raisePriority())
+        cerr << std::format("Warning: failed to raise the scheduling priority.\n");
+
+    auto const environment = probeEnvironment(cpu);
+    if (auto const governor = environment.find("cpu governor");
+        governor != environment.end() && governor->second != "performance")
+        cerr << std::format("Warning: CPU governor is '{}', frequency scaling may distort results.\n",
+                            governor->second);
+
+#if !defined(_WIN32)
+    // The load average counts runnable processes, so it is compared per CPU.
+    auto const cpuCount = std::max(std::thread::hardware_concurrency(), 1u);
+    double load = 0;
+    if (getloadavg(&load, 1) == 1 && load / cpuCount > NoisyLoadPerCpu)
+    {
+        cerr << std::format("{}: load average is {:.2f} on {} CPUs, other processes may distort results.\n",
+                            settings.allowNoisy ? "Warning" : "Error",
+                            load,
+                            cpuCount);
+        if (!settings.allowNoisy)
+        {
+            cerr << std::format("Use --allow-noisy to run anyway.\n");
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
 void changeTerminalSize(TerminalSize requestedTerminalSize)
 {
     cout << std::format("\033[8;{};{}t", requestedTerminalSize.lines, requestedTerminalSize.columns);
     cout.flush();
 }
 
-struct WithScopedTerminalSize
+/// Changes the terminal size for the benchmarks and restores the initial size once, when going out of scope.
+class ScopedTerminalSize
 {
-    TerminalSize initialTerminalSize;
-    TerminalSize requestedTerminalSize;
-    std::function<void()> inner;
-
-    void operator()()
+  public:
+    explicit ScopedTerminalSize(TerminalSize initialTerminalSize) noexcept:
+        _initial { initialTerminalSize }, _current { initialTerminalSize }
     {
-        if (requestedTerminalSize != initialTerminalSize)
-            changeTerminalSize(requestedTerminalSize);
+    }
 
-        inner();
+    ~ScopedTerminalSize()
+    {
+        if (_current != _initial)
+            changeTerminalSize(_initial);
     }
 
-    ~WithScopedTerminalSize()
+    ScopedTerminalSize(ScopedTerminalSize const&) = delete;
+    ScopedTerminalSize& operator=(ScopedTerminalSize const&) = delete;
+
+    /// Requests the given terminal size. If @p verify is set, waits for the terminal to report that size,
+    /// and returns false if it does not do so in time.
+    bool change(TerminalSize requestedTerminalSize, bool verify)
     {
-        if (requestedTerminalSize != initialTerminalSize)
-            changeTerminalSize(initialTerminalSize);
+        auto constexpr Timeout = std::chrono::seconds { 1 };
+
+        if (requestedTerminalSize == _current)
+            return true;
+        changeTerminalSize(requestedTerminalSize);
+        _current = requestedTerminalSize;
+        if (!verify)
+            return true;
+
+        auto const deadline = std::chrono::steady_clock::now() + Timeout;
+        while (getTerminalSize() != requestedTerminalSize)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds { 10 });
+        }
+        return true;
     }
+
+  private:
+    TerminalSize _initial;
+    TerminalSize _current;
 };
 
 } // namespace
@@ -308,33 +852,133 @@ int main(int argc, char const* argv[])
     if (settings.earlyExitCode)
         return settings.earlyExitCode.value();
 
+    if (settings.stableCpu && !prepareStableRun(settings))
+        return EXIT_FAILURE;
+
+    // Calibration writes the same way as the benchmark, but into the null device.
+    auto nullDevice = std::optional<FileHandle> {};
+    if (settings.calibrate)
+    {
+        nullDevice = openNullDevice();
+        if (!nullDevice)
+        {
+            cerr << std::format("Failed to open the null device for calibration.\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The models are loaded only once, not for every size of a sweep.
+    auto const workloadModels = loadWorkloadModels(settings.synthesizedTests);
+    if (!workloadModels)
+        return EXIT_FAILURE;
+
     auto const writer = settings.nullSink         ? nullWrite
                         : settings.stdoutFastPath ? chunkedWriteToStdout<STDOUT_FASTPATH_FD>
                                                   : chunkedWriteToStdout<STDOUT_FILENO>;
 
-    termbench::Benchmark tb { writer,
-                              settings.testSizeMB, // MB per test
-                              settings.requestedTerminalSize };
+    // Tests may confirm that the terminal has caught up by a DA1 round trip,
+    // which requires reading the terminal's reply from stdin.
+    // The terminal is asked once before measuring, so that no test waits for replies that never come.
+    // Once the terminal did not answer, no further round trips are attempted in any benchmark.
+    auto roundTrip = std::function<bool()> {};
+#if !defined(_WIN32)
+    auto rawInput = std::optional<ScopedRawInput> {};
+    auto const outputFd = settings.stdoutFastPath ? STDOUT_FASTPATH_FD : STDOUT_FILENO;
+    if (!settings.nullSink && isatty(STDIN_FILENO) && isatty(outputFd))
+    {
+        rawInput.emplace();
+        if (rawInput->active() && !requestPrimaryDeviceAttributes(writer))
+            cerr << std::format("Warning: the terminal did not answer DA1, disabling round trips.\n");
+        else if (rawInput->active())
+            roundTrip = [writer, unanswered = std::make_shared<bool>(false)]() {
+                if (*unanswered)
+                    return false;
+                *unanswered = !requestPrimaryDeviceAttributes(writer);
+                return !*unanswered;
+            };
+    }
+#endif
 
-    if (!addTestsToBenchmark(tb, settings))
-        return EXIT_FAILURE;
+    // Without --size-sweep, all tests run once at the requested terminal size.
+    auto const terminalSizes =
+        settings.sizeSweep.empty() ? std::vector { settings.requestedTerminalSize } : settings.sizeSweep;
+
+    // A size of the sweep that the terminal does not change to is skipped,
+    // which can only be told if the terminal size can be read back.
+    auto verifyResize = false;
+#if !defined(_WIN32)
+    verifyResize = !settings.sizeSweep.empty() && !settings.nullSink && isatty(STDIN_FILENO);
+#endif
+
+    auto benchmarks = std::vector<termbench::Benchmark> {};
+    benchmarks.reserve(terminalSizes.size());
+    {
+        auto scopedTerminalSize = ScopedTerminalSize { initialTerminalSize };
+        for (auto const terminalSize: terminalSizes)
+        {
+            if (!scopedTerminalSize.change(terminalSize, verifyResize))
+            {
+                cerr << std::format("Could not resize the terminal to {}x{}, skipping this size.\n",
+                                    terminalSize.columns,
+                                    terminalSize.lines);
+                continue;
+            }
+
+            auto sizeSettings = settings;
+            sizeSettings.requestedTerminalSize = terminalSize;
+
+            auto& tb = benchmarks.emplace_back(writer,
+                                               settings.testSizeMB, // MB per test
+                                               terminalSize,
+                                               std::function<void(termbench::Test const&)> {},
+                                               roundTrip);
+
+            if (!addTestsToBenchmark(tb, sizeSettings, *workloadModels))
+                return EXIT_FAILURE;
 
-    WithScopedTerminalSize {
-        initialTerminalSize,
-        settings.requestedTerminalSize,
-        [&]() { tb.runAll(); },
-    }();
+            if (roundTrip)
+                tb.setTerminalSizeProbe(getTerminalSize);
+            if (nullDevice)
+                tb.enableCalibration(
+                    [file = *nullDevice](char const* data, size_t size) { chunkedWrite(file, data, size); });
+            if (settings.stableCpu)
+                tb.setEnvironmentProbe([cpu = *settings.stableCpu]() { return probeEnvironment(cpu); });
+
+            tb.runAll();
+        }
+    }
+
+#if !defined(_WIN32)
+    rawInput.reset();
+#endif
 
     cout << "\033[m\033[H\033[J";
     cout.flush();
     if (settings.fileout.empty())
-        tb.summarize(cout);
+    {
+        if (settings.sizeSweep.empty())
+            benchmarks.front().summarize(cout);
+        else
+            termbench::summarizeSweep(cout, benchmarks);
+    }
     else
     {
         cout << "Writing summary into " << settings.fileout << std::endl;
         std::ofstream writerToFile;
         writerToFile.open(settings.fileout);
-        tb.summarizeToJson(writerToFile);
+        if (settings.sizeSweep.empty())
+            benchmarks.front().summarizeToJson(writerToFile);
+        else
+            termbench::summarizeSweepToJson(writerToFile, benchmarks);
+    }
+
+    if (nullDevice)
+    {
+#if !defined(_WIN32)
+        close(*nullDevice);
+#else
+        CloseHandle(*nullDevice);
+#endif
     }
 
 #if defined(_WIN32)